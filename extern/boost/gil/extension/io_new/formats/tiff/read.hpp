@@ -450,7 +450,7 @@ private:
          )
       {
          _io_dev.read_scanline( row_buffer_helper.buffer()
-                              , row
+                              , row + this->_settings._top_left.y
                               , static_cast< tsample_t >( plane )
                               );
 
@@ -271,7 +271,7 @@ public:
     FT rs = abs(r);
     FT dx = nx+rs*ny;
     FT dy = ny+rs*nx;
-    return Iso_Rectangle_2(c.x()-dx,c.y()-dy,c.x()+dx,c.y()+dy);
+    return Iso_rectangle_2(c.x()-dx,c.y()-dy,c.x()+dx,c.y()+dy);
   }
 
   // returns the positive scale so that q in on the boundary of "scaled this"
@@ -37,19 +37,12 @@ knowledge of the CeCILL license and that you accept its terms.
 #ifndef GEOMETRY_CIRCLE_2_IMAGE_ERROR_HPP
 #define GEOMETRY_CIRCLE_2_IMAGE_ERROR_HPP
 
+#include <cmath>
+#include <algorithm>
 #include "rjmcmc/geometry/Circle_2.hpp"
 #include "rjmcmc/image/image_types.hpp"
-
-
-template<typename V, typename F>
-inline typename F::result_type apply_operation(const V& v, const F &f) {
-    return f(v);
-}
-
-template<typename T, typename F>
-inline typename F::result_type apply_operation(const boost::gil::any_image_view<T>& v, const F &f) {
-    return boost::gil::apply_operation(v, f);
-}
+#include "rjmcmc/image/integral_image.hpp"
+#include "apply_operation.hpp"
 
 struct Circle_2_image_error_functor
 {
@@ -90,5 +83,24 @@ double image_error(const OrientedImage& v, const geometry::Circle_2<K> &c) {
     return apply_operation(v.view(), f);
 }
 
+// same pixels as above, summed row by row on the integral image in O(radius)
+template<typename K>
+double image_error(const integral_image& s, const geometry::Circle_2<K> &c) {
+    double r = geometry::radius(c);
+    double x = c.center().x()-s.x0();
+    double y = c.center().y()-s.y0();
+    int j0 = std::max(0,(int) std::ceil (y-r));
+    int j1 = std::min(s.height()-1,(int) std::floor(y+r));
+    double res = 0;
+    for ( int j = j0 ; j<=j1 ; ++j)
+    {
+        double h2 = r*r-(y-j)*(y-j);
+        if (h2<0) continue;
+        double h = std::sqrt(h2);
+        res += s.row_sum(j,(int) std::ceil(x-h),(int) std::floor(x+h)+1);
+    }
+    return res;
+}
+
 #endif // GEOMETRY_CIRCLE_2_IMAGE_ERROR_HPP
 
@@ -37,14 +37,97 @@ knowledge of the CeCILL license and that you accept its terms.
 #ifndef GEOMETRY_RECTANGLE_2_IMAGE_ERROR_HPP
 #define GEOMETRY_RECTANGLE_2_IMAGE_ERROR_HPP
 
+#include <cmath>
+#include <limits>
+#include <algorithm>
 #include "rjmcmc/geometry/Rectangle_2.hpp"
+#include "rjmcmc/image/image_types.hpp"
+#include "rjmcmc/image/integral_image.hpp"
+#include "apply_operation.hpp"
+
+// Rows of the pixels (i,j) of an image with origin (x0,y0) whose centre lies in a rectangle :
+// the rectangle intersects the row j in the span [xmin(j),xmax(j)]
+struct Rectangle_2_scanline
+{
+    double x[4], y[4];
+    int j0, j1; // first and last rows
+    template<typename K>
+    Rectangle_2_scanline(const geometry::Rectangle_2<K> &r, int x0, int y0) {
+        double ymin = std::numeric_limits<double>::infinity(), ymax = -ymin;
+        for(int k=0; k<4; ++k) {
+            x[k] = geometry::to_double(r.point(k).x())-x0;
+            y[k] = geometry::to_double(r.point(k).y())-y0;
+            ymin = std::min(ymin,y[k]);
+            ymax = std::max(ymax,y[k]);
+        }
+        j0 = (int) std::ceil (ymin);
+        j1 = (int) std::floor(ymax);
+    }
+    // pixels i0<=i<i1 of the row j, if i0<i1
+    void span(int j, int& i0, int& i1) const {
+        double xmin = std::numeric_limits<double>::infinity(), xmax = -xmin;
+        for(int k=0; k<4; ++k) {
+            int l = (k+1)%4;
+            if((y[k]<j && y[l]<j) || (y[k]>j && y[l]>j)) continue;
+            if(y[k]==y[l]) {
+                xmin = std::min(xmin,std::min(x[k],x[l]));
+                xmax = std::max(xmax,std::max(x[k],x[l]));
+            } else {
+                double xj = x[k]+(j-y[k])*(x[l]-x[k])/(y[l]-y[k]);
+                xmin = std::min(xmin,xj);
+                xmax = std::max(xmax,xj);
+            }
+        }
+        i0 = (int) std::ceil (xmin);
+        i1 = (int) std::floor(xmax)+1;
+    }
+};
+
+struct Rectangle_2_image_error_functor
+{
+    Rectangle_2_scanline s;
+    template<typename K>
+    Rectangle_2_image_error_functor(const geometry::Rectangle_2<K> &r, int x0, int y0) : s(r,x0,y0) {}
+
+    typedef double result_type;
+    template <typename T> result_type operator()(const T& v) const {
+        double res = 0;
+        int j0 = std::max(0,s.j0);
+        int j1 = std::min((int) v.height()-1,s.j1);
+        for ( int j = j0 ; j<=j1 ; ++j)
+        {
+            int i0, i1;
+            s.span(j,i0,i1);
+            i0 = std::max(0,i0);
+            i1 = std::min((int) v.width(),i1);
+            typename T::x_iterator it = v.row_begin(j)+i0;
+            for ( int i = i0 ; i<i1 ; ++i, ++it)
+                res += boost::gil::at_c<0>(*it);
+        }
+        return res;
+    }
+};
 
-/*
-//TODO
 template<typename OrientedImage, typename K>
-double image_error(const OrientedImage&, const geometry::Rectangle_2<K> &) {
-    return 0;
+double image_error(const OrientedImage& v, const geometry::Rectangle_2<K> &r) {
+    Rectangle_2_image_error_functor f(r,v.x0(), v.y0());
+    return apply_operation(v.view(), f);
+}
+
+// same pixels, summed row by row on the integral image in O(height)
+template<typename K>
+double image_error(const integral_image& s, const geometry::Rectangle_2<K> &r) {
+    Rectangle_2_scanline l(r,s.x0(),s.y0());
+    int j0 = std::max(0,l.j0);
+    int j1 = std::min(s.height()-1,l.j1);
+    double res = 0;
+    for ( int j = j0 ; j<=j1 ; ++j)
+    {
+        int i0, i1;
+        l.span(j,i0,i1);
+        res += s.row_sum(j,i0,i1);
+    }
+    return res;
 }
-*/
 
 #endif // GEOMETRY_RECTANGLE_2_IMAGE_ERROR_HPP
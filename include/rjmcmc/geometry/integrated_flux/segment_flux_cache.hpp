@@ -0,0 +1,192 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+#ifndef GEOMETRY_SEGMENT_FLUX_CACHE_HPP
+#define GEOMETRY_SEGMENT_FLUX_CACHE_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include <boost/cstdint.hpp>
+#include "rjmcmc/geometry/geometry.hpp"
+#include "batched_integrated_flux.hpp"
+
+// Cache of the integrated flux of segments, keyed by an end point and the direction of the segment.
+// The flux is additive along a segment : a segment that shares an end point and a direction with a cached
+// segment is computed from the cached flux and the flux of the piece by which their lengths differ.
+// A rectangle edge move keeps the opposite edge, and one end point and the direction of the two adjacent edges,
+// so that only the moved edge and two pieces are traversed.
+// The cache is a direct mapped table : an entry overwrites the one with the same slot.
+// The cache is not thread safe. Copies are empty so that each copy of an energy has its own cache.
+class segment_flux_cache
+{
+public:
+    // capacity is rounded up to a power of 2
+    explicit segment_flux_cache(std::size_t capacity = (1<<16))
+        : m_table(round_capacity(capacity)), m_hits(0), m_partial_hits(0), m_misses(0) {}
+    segment_flux_cache(const segment_flux_cache& c)
+        : m_table(c.m_table.size()), m_hits(0), m_partial_hits(0), m_misses(0) {}
+    segment_flux_cache& operator=(const segment_flux_cache& c)
+    {
+        if(this!=&c) { m_table.assign(c.m_table.size(),entry()); m_hits = m_partial_hits = m_misses = 0; }
+        return *this;
+    }
+
+    template<typename OrientedImage, typename Segment>
+    double operator()(const OrientedImage& v, const Segment& s)
+    {
+        typedef typename Segment::R K;
+        typedef typename K::Point_2 Point_2;
+        typedef typename K::Vector_2 Vector_2;
+        Vector_2 edge(s.target()-s.source());
+        double length = std::sqrt(geometry::to_double(edge.squared_length()));
+        if(length==0) return 0.;
+        Vector_2 u(edge/length);
+        key ks(make_key(s.source(),u,true));
+        key kt(make_key(s.target(),u,false));
+        double flux;
+        const entry *c = find(ks);
+        if(c) {
+            // same source : extend or shorten the cached segment at its target
+            Point_2 p(s.source()+u*c->length);
+            flux = extend<K>(v,c,length,s.target(),p,false);
+        } else if((c = find(kt))) {
+            // same target : extend or shorten the cached segment at its source
+            Point_2 p(s.target()-u*c->length);
+            flux = extend<K>(v,c,length,s.source(),p,true);
+        } else {
+            ++m_misses;
+            flux = segment_flux<K>(v,s);
+        }
+        insert(ks,length,flux);
+        insert(kt,length,flux);
+        return flux;
+    }
+
+    void clear()
+    {
+        m_table.assign(m_table.size(),entry());
+        m_hits = m_partial_hits = m_misses = 0;
+    }
+
+    inline std::size_t hits        () const { return m_hits; }
+    inline std::size_t partial_hits() const { return m_partial_hits; }
+    inline std::size_t misses      () const { return m_misses; }
+
+private:
+    struct key {
+        boost::int64_t x, y, dx, dy;
+        bool source;
+        bool operator==(const key& k) const { return x==k.x && y==k.y && dx==k.dx && dy==k.dy && source==k.source; }
+    };
+    struct entry {
+        key k;
+        double length, flux;
+        bool valid;
+        entry() : valid(false) {}
+    };
+
+    static std::size_t round_capacity(std::size_t capacity)
+    {
+        std::size_t n = 1;
+        while(n<capacity) n <<= 1;
+        return n;
+    }
+
+    inline entry& slot(const key& k)
+    {
+        boost::uint64_t h = (boost::uint64_t) k.x;
+        h = (h ^ (boost::uint64_t) k.y ) * 0x9E3779B97F4A7C15ULL;
+        h = (h ^ (boost::uint64_t) k.dx) * 0xBF58476D1CE4E5B9ULL;
+        h = (h ^ (boost::uint64_t) k.dy) * 0x94D049BB133111EBULL;
+        h ^= (h >> 31) ^ (boost::uint64_t) k.source;
+        return m_table[(std::size_t) h & (m_table.size()-1)];
+    }
+
+    // coordinates are quantized, so that end points that are equal up to rounding share their key
+    static inline boost::int64_t quantize(double x) { return (boost::int64_t) std::floor(x*1048576.+0.5); }
+
+    template<typename Point, typename Vector>
+    static key make_key(const Point& p, const Vector& u, bool source)
+    {
+        key k;
+        k.x  = quantize(geometry::to_double(p.x()));
+        k.y  = quantize(geometry::to_double(p.y()));
+        k.dx = quantize(geometry::to_double(u.x()));
+        k.dy = quantize(geometry::to_double(u.y()));
+        k.source = source;
+        return k;
+    }
+
+    inline const entry* find(const key& k)
+    {
+        const entry& e = slot(k);
+        return (e.valid && e.k==k) ? &e : 0;
+    }
+
+    inline void insert(const key& k, double length, double flux)
+    {
+        entry& e = slot(k);
+        e.k      = k;
+        e.length = length;
+        e.flux   = flux;
+        e.valid  = true;
+    }
+
+    template<typename K, typename OrientedImage, typename Segment>
+    static inline double segment_flux(const OrientedImage& v, const Segment& s)
+    {
+        return batched_integrated_flux<K>(v,s);
+    }
+
+    // flux of a segment from the cached flux of a collinear segment with a common end point.
+    // p is the free end point of the segment, q the one of the cached segment, and at_source tells which end is free.
+    template<typename K, typename OrientedImage, typename Point>
+    double extend(const OrientedImage& v, const entry *c, double length, const Point& p, const Point& q, bool at_source)
+    {
+        typedef typename K::Segment_2 Segment_2;
+        if(length==c->length) { ++m_hits; return c->flux; }
+        ++m_partial_hits;
+        // pieces are oriented as the segment, so that their normals agree
+        if(length>c->length) return c->flux + segment_flux<K>(v,at_source ? Segment_2(p,q) : Segment_2(q,p));
+        return c->flux - segment_flux<K>(v,at_source ? Segment_2(q,p) : Segment_2(p,q));
+    }
+
+    std::vector<entry> m_table;
+    std::size_t m_hits, m_partial_hits, m_misses;
+};
+
+#endif // GEOMETRY_SEGMENT_FLUX_CACHE_HPP
@@ -0,0 +1,101 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+#ifndef GEOMETRY_RECTANGLE_2_BATCH_INTERSECTION_HPP
+#define GEOMETRY_RECTANGLE_2_BATCH_INTERSECTION_HPP
+
+#include <cmath>
+#include <algorithm>
+#include "rjmcmc/geometry/Rectangle_2.hpp"
+#include "Rectangle_2_intersection.hpp"
+
+// Batched intersection areas of a rectangle a with n rectangles : the rectangles are first transformed to the frame of a,
+// where a is the box [-1,1]x[-|ra|,|ra|], and tested against the separating axes of a and of themselves in a loop over
+// plain arrays that the compiler may vectorize, then the areas of the intersecting ones are computed by intersection_area.
+
+namespace geometry {
+
+namespace Impl {
+
+    // frame of a : coordinates of v are (v.n, v.m)/|n|^2 with m the normal rotated by 90 degrees
+    template<class K> struct rectangle_frame {
+        double cx, cy, nx, ny, n2, m;
+        rectangle_frame(const Rectangle_2<K>& a) {
+            cx = to_double(a.center().x()); cy = to_double(a.center().y());
+            nx = to_double(a.normal().x()); ny = to_double(a.normal().y());
+            n2 = nx*nx+ny*ny;
+            m  = std::abs(to_double(a.ratio()));
+            nx /= n2; ny /= n2;
+        }
+        // center, half axes u (along the normal of b) and v (along its rotated normal) of b in the frame
+        inline void transform(const Rectangle_2<K>& b, double& x, double& y, double& ux, double& uy, double& vx, double& vy) const {
+            double dx = to_double(b.center().x())-cx, dy = to_double(b.center().y())-cy;
+            double bx = to_double(b.normal().x()), by = to_double(b.normal().y()), r = std::abs(to_double(b.ratio()));
+            x  = nx*dx+ny*dy; y  = nx*dy-ny*dx;
+            ux = nx*bx+ny*by; uy = nx*by-ny*bx;
+            vx = -r*uy;       vy = r*ux;
+        }
+    };
+
+} // namespace Impl
+
+// area[i] = intersection area of a and b[i], for i in [0,n)
+template<class K> void intersection_areas(const Rectangle_2<K>& a, const Rectangle_2<K> *b, int n, double *area)
+{
+    enum { batch = 16 };
+    if(a.is_degenerate()) { for(int i=0; i<n; ++i) area[i] = 0; return; }
+    Impl::rectangle_frame<K> f(a);
+    double x[batch], y[batch], ux[batch], uy[batch], vx[batch], vy[batch];
+    int hit[batch];
+    for(int i0=0; i0<n; i0+=batch) {
+        int k = std::min<int>(batch,n-i0);
+        for(int i=0; i<k; ++i) f.transform(b[i0+i],x[i],y[i],ux[i],uy[i],vx[i],vy[i]);
+        // separating axes : the sides of a, then the sides of b (projections on u and v, whose squared lengths are |u|^2 and |v|^2)
+        for(int i=0; i<k; ++i) {
+            double ex = std::abs(ux[i])+std::abs(vx[i]), ey = std::abs(uy[i])+std::abs(vy[i]);
+            double u2 = ux[i]*ux[i]+uy[i]*uy[i], v2 = vx[i]*vx[i]+vy[i]*vy[i];
+            double pu = std::abs(x[i]*ux[i]+y[i]*uy[i]), pv = std::abs(x[i]*vx[i]+y[i]*vy[i]);
+            double au = std::abs(ux[i])+f.m*std::abs(uy[i]), av = std::abs(vx[i])+f.m*std::abs(vy[i]);
+            hit[i] = (std::abs(x[i])<1+ex) & (std::abs(y[i])<f.m+ey) & (pu<u2+au) & (pv<v2+av) & (u2*v2>0);
+        }
+        for(int i=0; i<k; ++i)
+            area[i0+i] = hit[i] ? std::abs(to_double(intersection_area(a,b[i0+i]))) : 0.;
+    }
+}
+
+}; // namespace geometry
+
+#endif // GEOMETRY_RECTANGLE_2_BATCH_INTERSECTION_HPP
@@ -0,0 +1,110 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+#ifndef GRADIENT_CACHE_HPP
+#define GRADIENT_CACHE_HPP
+
+#include <string>
+#include <sstream>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <boost/functional/hash.hpp>
+#include <boost/filesystem.hpp>
+#include "image_types.hpp"
+#include "oriented_inc.hpp"
+#include "mapped_image.hpp"
+
+// Gradient of the region bbox of an image file, computed by f (gradient_functor or parallel_gradient_functor),
+// and cached in the directory cache_dir as a memory mapped image file.
+// The cache entry is keyed by the absolute path and modification time of the file, the region and f.sigma(),
+// so that a modified input or other parameters give another entry. An empty cache_dir disables the cache,
+// as does a file whose path or modification time cannot be read : the gradient is then computed without the cache
+// (it is empty if the file cannot be read either).
+template<typename IsoRectangle, typename Functor>
+oriented<gradient_image_t> cached_gradient(const std::string& file, const IsoRectangle& bbox, const Functor& f, const std::string& cache_dir)
+{
+    namespace fs = boost::filesystem;
+    if(cache_dir.empty()) return oriented<gradient_image_t>(file, bbox, f);
+
+    boost::system::error_code ec;
+    fs::path path = fs::canonical(file, ec);
+    if(ec) return oriented<gradient_image_t>(file, bbox, f);
+    std::time_t time = fs::last_write_time(path, ec);
+    if(ec) return oriented<gradient_image_t>(file, bbox, f);
+
+    std::ostringstream key;
+    key << path.string() << '\n' << time << '\n'
+        << (int) bbox.min().x() << ' ' << (int) bbox.min().y() << ' ' << (int) bbox.max().x() << ' ' << (int) bbox.max().y() << '\n'
+        << std::setprecision(17) << f.sigma() << '\n';
+    std::ostringstream name;
+    name << "gradient_" << std::hex << boost::hash_value(key.str());
+    fs::path entry = fs::path(cache_dir) / (name.str()+".map");
+    fs::path entry_key = fs::path(cache_dir) / (name.str()+".key");
+
+    // the key file guards against hash collisions
+    {
+        std::ifstream in(entry_key.string().c_str(), std::ios::binary);
+        std::string k((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        oriented<gradient_image_t> grad;
+        if(k==key.str() && map_image(entry.string(), grad)) return grad;
+    }
+
+    oriented<gradient_image_t> grad(file, bbox, f);
+    if(!grad.img()) return grad;
+    // entries are written under temporary names then renamed, so that concurrent runs never map a partial file
+    fs::create_directories(cache_dir, ec);
+    fs::path unique = fs::unique_path("%%%%-%%%%-%%%%-%%%%", ec);
+    if(ec) return grad;
+    std::ostringstream suffix;
+    suffix << ".tmp" << unique.string();
+    fs::path tmp = entry.string()+suffix.str(), tmp_key = entry_key.string()+suffix.str();
+    bool written = write_mapped_image(tmp.string(), grad);
+    {
+        std::ofstream out(tmp_key.string().c_str(), std::ios::binary);
+        out << key.str();
+        written = written && out;
+    }
+    if(written) {
+        fs::rename(tmp, entry, ec);
+        if(!ec) fs::rename(tmp_key, entry_key, ec);
+    }
+    fs::remove(tmp, ec);
+    fs::remove(tmp_key, ec);
+    return grad;
+}
+
+#endif // GRADIENT_CACHE_HPP
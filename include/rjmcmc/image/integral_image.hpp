@@ -0,0 +1,114 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+#ifndef INTEGRAL_IMAGE_HPP
+#define INTEGRAL_IMAGE_HPP
+
+#include <vector>
+#include <algorithm>
+#include <boost/gil/image.hpp>
+#include <boost/gil/extension/dynamic_image/any_image.hpp>
+#include <boost/gil/extension/dynamic_image/apply_operation.hpp>
+#include "oriented.hpp"
+
+// Summed area table of the first channel of an image, with the origin (x0,y0) of the image.
+// Sums of the pixel values over boxes are computed in constant time.
+class integral_image {
+public:
+    integral_image() : m_x0(0), m_y0(0), m_width(0), m_height(0), m_sum(1,0.) {}
+
+    template<typename Image>
+    explicit integral_image(const oriented<Image>& img) : m_x0(img.x0()), m_y0(img.y0()), m_width(0), m_height(0)
+    {
+        init(img.view());
+    }
+
+    template<typename Types>
+    explicit integral_image(const oriented<boost::gil::any_image<Types> >& img) : m_x0(img.x0()), m_y0(img.y0()), m_width(0), m_height(0)
+    {
+        boost::gil::apply_operation(img.view(), initializer(*this));
+    }
+
+    inline int x0() const { return m_x0; }
+    inline int y0() const { return m_y0; }
+    inline int width () const { return m_width; }
+    inline int height() const { return m_height; }
+
+    // sum of the pixels (i,j) such that i0<=i<i1 and j0<=j<j1, in image coordinates (relative to the origin).
+    // The box is clipped to the image.
+    inline double sum(int i0, int j0, int i1, int j1) const
+    {
+        i0 = std::max(i0,0); i1 = std::min(i1,m_width );
+        j0 = std::max(j0,0); j1 = std::min(j1,m_height);
+        if(i0>=i1 || j0>=j1) return 0.;
+        return at(i1,j1)-at(i0,j1)-at(i1,j0)+at(i0,j0);
+    }
+
+    // sum of the pixels (i,j) of the row j such that i0<=i<i1, in image coordinates
+    inline double row_sum(int j, int i0, int i1) const { return sum(i0,j,i1,j+1); }
+
+private:
+    struct initializer {
+        typedef void result_type;
+        integral_image& m_img;
+        initializer(integral_image& img) : m_img(img) {}
+        template<typename View> void operator()(const View& v) const { m_img.init(v); }
+    };
+
+    template<typename View>
+    void init(const View& v)
+    {
+        m_width  = v.width ();
+        m_height = v.height();
+        std::size_t w = m_width+1;
+        m_sum.assign(w*(m_height+1),0.);
+        for(int j=0; j<m_height; ++j) {
+            typename View::x_iterator it = v.row_begin(j);
+            double row = 0.;
+            for(int i=0; i<m_width; ++i, ++it) {
+                row += boost::gil::at_c<0>(*it);
+                m_sum[(j+1)*w+i+1] = m_sum[j*w+i+1]+row;
+            }
+        }
+    }
+
+    inline double at(int i, int j) const { return m_sum[j*(m_width+1)+i]; }
+
+    int m_x0, m_y0, m_width, m_height;
+    std::vector<double> m_sum; // (width+1)x(height+1), zero on the first row and column
+};
+
+#endif // INTEGRAL_IMAGE_HPP
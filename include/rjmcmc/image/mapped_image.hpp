@@ -0,0 +1,144 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+#ifndef MAPPED_IMAGE_HPP
+#define MAPPED_IMAGE_HPP
+
+#include <cstring>
+#include <string>
+#include <fstream>
+#include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/type_traits/is_floating_point.hpp>
+#include <boost/type_traits/is_signed.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/gil/image.hpp>
+#include "oriented.hpp"
+
+// Uncompressed image files that are memory mapped instead of read :
+// pixels are paged in by the system when they are accessed, so that resident memory stays bounded.
+// The file is a header followed by the pixels, row by row, without padding, in the byte order of the machine :
+// files written on a machine of another byte order, or with another channel type, are not mapped.
+
+// tag of the channel type of Pixel : its kind (unsigned integer 0, signed integer 1, floating point 2) and its size in bytes
+template<typename Pixel>
+struct mapped_channel_tag {
+    typedef typename boost::gil::channel_type<Pixel>::type channel_t;
+    typedef typename boost::gil::channel_traits<channel_t>::value_type value_type;
+    static boost::uint32_t value()
+    {
+        boost::uint32_t kind = boost::is_floating_point<value_type>::value ? 2 : (boost::is_signed<value_type>::value ? 1 : 0);
+        return (kind<<8) | boost::uint32_t(sizeof(value_type));
+    }
+};
+
+struct mapped_image_header {
+    char magic[8];
+    boost::uint32_t byte_order; // byte_order_mark(), as written by the machine that wrote the file
+    boost::uint32_t pixel_size, channels, channel_tag, width, height;
+    boost::int32_t x0, y0;
+
+    static const char* signature() { return "RJMCMCI2"; }
+    static boost::uint32_t byte_order_mark() { return 0x01020304; }
+    bool valid() const { return std::memcmp(magic,signature(),8)==0 && byte_order==byte_order_mark(); }
+
+    template<typename Pixel> bool holds() const
+    {
+        return pixel_size==sizeof(Pixel) && channels==boost::gil::num_channels<Pixel>::value
+            && channel_tag==mapped_channel_tag<Pixel>::value();
+    }
+};
+
+// writes the view of img, with its origin
+template<typename Image>
+bool write_mapped_image(const std::string& file, const oriented<Image>& img)
+{
+    typedef typename Image::view_t::value_type pixel_t;
+    mapped_image_header h;
+    std::memcpy(h.magic,mapped_image_header::signature(),8);
+    h.byte_order = mapped_image_header::byte_order_mark();
+    h.pixel_size = sizeof(pixel_t);
+    h.channels   = boost::gil::num_channels<pixel_t>::value;
+    h.channel_tag= mapped_channel_tag<pixel_t>::value();
+    h.width      = img.view().width ();
+    h.height     = img.view().height();
+    h.x0         = img.x0();
+    h.y0         = img.y0();
+    std::ofstream out(file.c_str(), std::ios::binary);
+    out.write((const char*) &h, sizeof(h));
+    for(int j=0; j<img.view().height(); ++j)
+        for(typename Image::view_t::x_iterator it=img.view().row_begin(j); it!=img.view().row_end(j); ++it) {
+            pixel_t p = *it;
+            out.write((const char*) &p, sizeof(p));
+        }
+    return bool(out);
+}
+
+namespace internal {
+    struct mapped_file {
+        boost::interprocess::file_mapping  m_file;
+        boost::interprocess::mapped_region m_region;
+        mapped_file(const std::string& file)
+            : m_file(file.c_str(), boost::interprocess::read_only)
+            , m_region(m_file, boost::interprocess::copy_on_write) {}
+    };
+};
+
+// maps the file written by write_mapped_image into img, which may then be modified without modifying the file.
+// Returns false if the file cannot be mapped, holds another pixel type or was written with another byte order.
+template<typename Image>
+bool map_image(const std::string& file, oriented<Image>& img)
+{
+    typedef typename Image::view_t view_t;
+    typedef typename view_t::value_type pixel_t;
+    boost::shared_ptr<internal::mapped_file> m;
+    try {
+        m.reset(new internal::mapped_file(file));
+    } catch(const boost::interprocess::interprocess_exception&) {
+        return false;
+    }
+    if(m->m_region.get_size()<sizeof(mapped_image_header)) return false;
+    const mapped_image_header& h = *(const mapped_image_header*) m->m_region.get_address();
+    if(!h.valid() || !h.template holds<pixel_t>()) return false;
+    std::size_t row_size = std::size_t(h.width)*sizeof(pixel_t);
+    if(m->m_region.get_size()<sizeof(mapped_image_header)+row_size*h.height) return false;
+    pixel_t *pixels = (pixel_t*) ((char*) m->m_region.get_address()+sizeof(mapped_image_header));
+    img = oriented<Image>(m, boost::gil::interleaved_view(h.width,h.height,pixels,row_size), h.x0, h.y0);
+    return true;
+}
+
+#endif // MAPPED_IMAGE_HPP
@@ -53,6 +53,10 @@ public:
     oriented(const boost::shared_ptr<Image>& img, int x0=0, int y0=0)
         : m_img(img), m_x0(x0), m_y0(y0) { if(img) m_view = view(*img); }
     oriented() : m_img(), m_view(), m_x0(0), m_y0(0) {}
+    // view of a storage other than an Image (e.g. a memory mapped file), kept alive by owner. img() is then null.
+    template<typename Owner>
+    oriented(const boost::shared_ptr<Owner>& owner, const view_t& view, int x0=0, int y0=0)
+        : m_img(), m_owner(owner), m_view(view), m_x0(x0), m_y0(y0) {}
 
     inline int x0() const { return m_x0; }
     inline int y0() const { return m_y0; }
@@ -76,6 +80,7 @@ public:
 
 private:
     boost::shared_ptr<Image> m_img;
+    boost::shared_ptr<void> m_owner;
     view_t m_view;
     int m_x0, m_y0;
 };
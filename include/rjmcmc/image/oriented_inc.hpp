@@ -81,14 +81,14 @@ void clip_bbox(IsoRectangle& bbox, const std::string &file)
 template<typename Image>
 template<typename ImageIn, typename IsoRectangle>
 oriented<Image>::oriented(const oriented<ImageIn>& img, const IsoRectangle& bbox)
-    : m_img(img.m_img)
+    : m_img(img.m_img), m_owner(img.m_owner)
 {
     using namespace boost::gil;
     int x0 = (int) bbox.min().x();
     int y0 = (int) bbox.min().y();
     int x1 = (int) bbox.max().x();
     int y1 = (int) bbox.max().y();
-    if(m_img) m_view = subimage_view(img.view(),x0-img.x0(),y0-img.y0(),x1-x0,y1-y0);
+    if(m_img || m_owner) m_view = subimage_view(img.view(),x0-img.x0(),y0-img.y0(),x1-x0,y1-y0);
     m_x0 = x0;
     m_y0 = y0;
 }
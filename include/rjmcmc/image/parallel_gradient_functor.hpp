@@ -0,0 +1,63 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+#ifndef PARALLEL_GRADIENT_FUNCTOR_HPP
+#define PARALLEL_GRADIENT_FUNCTOR_HPP
+
+#include "gradient_functor.hpp"
+
+// Drop-in replacement of gradient_functor, with the same output :
+// the image is processed by strips of rows on several threads, each strip applying both separable passes
+// of both channels while its rows are in cache.
+class parallel_gradient_functor
+{
+public:
+    typedef void result_type;
+    // nthreads = 0 : one thread per hardware core
+    parallel_gradient_functor(double sigma, unsigned int nthreads=0, unsigned int strip_height=64)
+        : m_sigma(sigma), m_nthreads(nthreads), m_strip_height(strip_height) {}
+    double sigma() const { return m_sigma; }
+    void sigma(double s) { m_sigma = s; }
+
+    template<typename Image, typename View>
+    result_type operator()(Image& g, const View& v) const;
+private:
+    double m_sigma;
+    unsigned int m_nthreads;
+    unsigned int m_strip_height;
+};
+
+#endif // PARALLEL_GRADIENT_FUNCTOR_HPP
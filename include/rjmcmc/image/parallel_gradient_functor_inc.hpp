@@ -0,0 +1,147 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+#ifndef PARALLEL_GRADIENT_FUNCTOR_INC_HPP
+#define PARALLEL_GRADIENT_FUNCTOR_INC_HPP
+
+#include <vector>
+#include <algorithm>
+#include "parallel_gradient_functor.hpp"
+#include "gradient_functor_inc.hpp"
+#include "rjmcmc/util/parallel_for.hpp"
+
+namespace internal {
+
+    // Computes the rows [j0,j1) of the gradient, as gradient_functor :
+    // channel 0 is the vertical smoothing followed by the horizontal derivative,
+    // channel 1 is the horizontal smoothing followed by the vertical derivative.
+    // Borders are extended by their constant value, and the float sums are accumulated in the order of boost::gil::convolve_*,
+    // so that the output is the same.
+    template<typename View, typename GView>
+    struct gradient_strip {
+        const View& m_src;
+        const GView& m_dst;
+        const std::vector<float>& m_smooth; // reversed kernels, as in convolution
+        const std::vector<float>& m_deriv;
+        unsigned int m_strip_height;
+
+        gradient_strip(const View& src, const GView& dst, const std::vector<float>& smooth, const std::vector<float>& deriv, unsigned int strip_height)
+            : m_src(src), m_dst(dst), m_smooth(smooth), m_deriv(deriv), m_strip_height(strip_height) {}
+
+        void operator()(unsigned int strip) const
+        {
+            int w = m_src.width(), h = m_src.height();
+            int ks = (int) m_smooth.size(), half = ks/2;
+            int j0 = strip*m_strip_height, j1 = std::min(h,(int) (j0+m_strip_height));
+            int rows = j1-j0+ks-1; // source rows j0-half .. j1+half-1, clamped to the image
+            std::vector<float> src(rows*w), hsmooth(rows*w), line(w+ks-1), acc(w);
+
+            for(int r=0; r<rows; ++r) {
+                int j = std::min(h-1,std::max(0,j0-half+r));
+                typename View::x_iterator it = m_src.row_begin(j);
+                float *s = &src[r*w];
+                for(int i=0; i<w; ++i, ++it) s[i] = float(boost::gil::at_c<0>(*it));
+                // horizontal smoothing (channel 1)
+                row_correlate(s,w,m_smooth,&line.front(),&hsmooth[r*w]);
+            }
+
+            for(int j=j0; j<j1; ++j) {
+                int r = j-j0;
+                // vertical smoothing then horizontal derivative (channel 0)
+                col_correlate(&src[r*w],w,m_smooth,&acc.front());
+                row_correlate(&acc.front(),w,m_deriv,&line.front(),&acc.front());
+                typename GView::x_iterator out = m_dst.row_begin(j);
+                for(int i=0; i<w; ++i) boost::gil::at_c<0>(out[i]) = acc[i];
+                // vertical derivative (channel 1)
+                col_correlate(&hsmooth[r*w],w,m_deriv,&acc.front());
+                for(int i=0; i<w; ++i) boost::gil::at_c<1>(out[i]) = acc[i];
+            }
+        }
+
+        // out[i] = sum_k in[i-half+k]*ker[k], in being extended by its end values. out may be in.
+        static void row_correlate(const float *in, int w, const std::vector<float>& ker, float *line, float *out)
+        {
+            int ks = (int) ker.size(), half = ks/2;
+            std::fill(line,line+half,in[0]);
+            std::copy(in,in+w,line+half);
+            std::fill(line+half+w,line+w+ks-1,in[w-1]);
+            for(int i=0; i<w; ++i) {
+                float a = 0.f;
+                for(int k=0; k<ks; ++k) a = a + line[i+k]*ker[k];
+                out[i] = a;
+            }
+        }
+
+        // out[i] = sum_k in[i+k*w]*ker[k], the ks rows from in being contiguous
+        static void col_correlate(const float *in, int w, const std::vector<float>& ker, float *out)
+        {
+            int ks = (int) ker.size();
+            std::fill(out,out+w,0.f);
+            for(int k=0; k<ks; ++k) {
+                const float *row = in+k*w;
+                float c = ker[k];
+                for(int i=0; i<w; ++i) out[i] = out[i] + row[i]*c;
+            }
+        }
+    };
+
+}
+
+template<typename Image, typename View>
+typename parallel_gradient_functor::result_type parallel_gradient_functor::operator()(Image& g, const View& v) const
+{
+    using namespace boost::gil;
+
+    g.recreate(v.dimensions());
+    if(v.width()==0 || v.height()==0) return;
+
+    unsigned int half_size = (unsigned int) (3* m_sigma) ;
+    const size_t kws = 2 * half_size + 1;
+    kernel_1d<float> ksmooth(kws, kws / 2);
+    kernel_1d<float> kderiv(kws, kws / 2);
+    internal::initKernelGaussian1D(ksmooth, m_sigma);
+    internal::initKernelGaussianDeriv1D(kderiv, m_sigma);
+    std::vector<float> smooth(ksmooth.rbegin(),ksmooth.rend());
+    std::vector<float> deriv (kderiv .rbegin(),kderiv .rend());
+
+    typedef typename Image::view_t g_view_t;
+    g_view_t gv = view(g);
+    unsigned int strip_height = std::max(1u,m_strip_height);
+    unsigned int strips = (v.height()+strip_height-1)/strip_height;
+    rjmcmc::parallel_for(strips, internal::gradient_strip<View,g_view_t>(v,gv,smooth,deriv,strip_height), m_nthreads);
+}
+
+#endif // PARALLEL_GRADIENT_FUNCTOR_INC_HPP
@@ -0,0 +1,129 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+#ifndef QUANTIZED_GRADIENT_HPP
+#define QUANTIZED_GRADIENT_HPP
+
+#include <cmath>
+#include <algorithm>
+#include <boost/shared_ptr.hpp>
+#include <boost/gil/image.hpp>
+#include <boost/gil/typedefs.hpp>
+#include "gradient_functor.hpp"
+
+typedef boost::gil::dev2n16s_image_t quantized_gradient_image_t;
+typedef boost::gil::dev2n16s_view_t  quantized_gradient_view_t;
+
+// Gradient image stored as 2 x int16 with a global scale (4 bytes per pixel instead of 8).
+// Its view_t dereferences to gradient pixels (dev2n32F) of value scale*int16, so that it provides the OrientedImage
+// interface (view_t, view(), x0(), y0()) of oriented<gradient_image_t> to integrated_flux and the energies.
+// With scale = max|g|/32767, each gradient component is rounded by at most scale/2, so that the integrated flux
+// of a rectangle or a circle differs from the float32 one by at most perimeter*scale/sqrt(2), up to float rounding (see max_error).
+class quantized_gradient
+{
+public:
+    class dequantize_fn {
+    public:
+        typedef dequantize_fn const_t;
+        typedef gradient_image_t::value_type value_type;
+        typedef value_type reference;
+        typedef value_type const_reference;
+        typedef quantized_gradient_image_t::value_type argument_type;
+        typedef reference result_type;
+        BOOST_STATIC_CONSTANT(bool, is_mutable=false);
+
+        dequantize_fn(float scale=1) : m_scale(scale) {}
+        result_type operator()(const argument_type& q) const
+        {
+            return value_type(m_scale*boost::gil::at_c<0>(q),m_scale*boost::gil::at_c<1>(q));
+        }
+    private:
+        float m_scale;
+    };
+    typedef quantized_gradient_view_t::add_deref<dequantize_fn>::type view_t;
+
+    quantized_gradient() : m_scale(1), m_x0(0), m_y0(0) {}
+
+    // quantizes an oriented gradient image (e.g. oriented<gradient_image_t>)
+    template<typename OrientedImage>
+    explicit quantized_gradient(const OrientedImage& grad) : m_x0(grad.x0()), m_y0(grad.y0())
+    {
+        typedef typename OrientedImage::view_t view_in_t;
+        const view_in_t& in = grad.view();
+        double max = 0;
+        for(int y=0; y<in.height(); ++y) {
+            typename view_in_t::x_iterator it = in.row_begin(y);
+            for(int x=0; x<in.width(); ++x, ++it)
+                max = std::max(max,std::max(std::abs(double(boost::gil::at_c<0>(*it))),std::abs(double(boost::gil::at_c<1>(*it)))));
+        }
+        m_scale = (max>0) ? float(max/32767.) : 1.f;
+        // the rounding uses the float scale actually used for dequantization
+        double inv = 1./m_scale;
+        m_img.reset(new quantized_gradient_image_t(in.width(),in.height()));
+        quantized_gradient_view_t out = boost::gil::view(*m_img);
+        for(int y=0; y<in.height(); ++y) {
+            typename view_in_t::x_iterator it = in.row_begin(y);
+            quantized_gradient_view_t::x_iterator o = out.row_begin(y);
+            for(int x=0; x<in.width(); ++x, ++it, ++o) {
+                boost::gil::at_c<0>(*o) = quantize(boost::gil::at_c<0>(*it)*inv);
+                boost::gil::at_c<1>(*o) = quantize(boost::gil::at_c<1>(*it)*inv);
+            }
+        }
+        m_view = quantized_gradient_view_t::add_deref<dequantize_fn>::make(out,dequantize_fn(m_scale));
+    }
+
+    inline int x0() const { return m_x0; }
+    inline int y0() const { return m_y0; }
+    inline const view_t& view() const { return m_view; }
+    inline const boost::shared_ptr<quantized_gradient_image_t>& img() const { return m_img; }
+    inline float scale() const { return m_scale; }
+    // upper bound of the flux error, versus the float32 gradient, of an object of the given perimeter
+    inline double max_error(double perimeter) const { return perimeter*m_scale*M_SQRT1_2; }
+
+private:
+    static inline boost::int16_t quantize(double x)
+    {
+        double r = std::floor(x+0.5);
+        return boost::int16_t(std::max(-32767.,std::min(32767.,r)));
+    }
+
+    boost::shared_ptr<quantized_gradient_image_t> m_img;
+    view_t m_view;
+    float m_scale;
+    int m_x0, m_y0;
+};
+
+#endif // QUANTIZED_GRADIENT_HPP
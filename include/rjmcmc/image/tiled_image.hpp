@@ -0,0 +1,164 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+#ifndef TILED_IMAGE_HPP
+#define TILED_IMAGE_HPP
+
+#include <list>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/gil/image.hpp>
+#include <boost/gil/virtual_locator.hpp>
+
+// A TileSource provides the pixels of a large image on demand :
+// - width() and height() of the image,
+// - load(image,x,y,w,h) recreates the image to w x h and fills it with the pixels [x,x+w)x[y,y+h) of the source.
+
+// Image read by tiles from a TileSource, the least recently used tiles being dropped beyond a given count of tiles.
+// Its view_t is a gil view, so that oriented<tiled_image<...> > can be used by the energies as any oriented image.
+// Pixels are returned by value, and outside pixels are default constructed. Tile accesses are thread safe.
+template<typename Image, typename TileSource>
+class tiled_image
+{
+public:
+    typedef Image                        tile_type;
+    typedef typename Image::value_type   value_type;
+    typedef boost::shared_ptr<const Image> tile_ptr;
+
+    // dereferences a point to its pixel, keeping the last tile used, so that most accesses do not lock
+    class deref_fn {
+    public:
+        typedef deref_fn const_t;
+        typedef typename Image::value_type value_type;
+        typedef value_type reference;
+        typedef value_type const_reference;
+        typedef boost::gil::point2<std::ptrdiff_t> argument_type;
+        typedef reference result_type;
+        BOOST_STATIC_CONSTANT(bool, is_mutable=false);
+
+        deref_fn(const tiled_image *img=0) : m_img(img), m_x(0), m_y(0), m_w(0), m_h(0) {}
+
+        result_type operator()(const argument_type& p) const
+        {
+            std::ptrdiff_t x = p.x-m_x, y = p.y-m_y;
+            if(x<0 || y<0 || x>=m_w || y>=m_h) {
+                if(!m_img || p.x<0 || p.y<0 || p.x>=m_img->width() || p.y>=m_img->height()) return value_type();
+                m_img->tile_at(p.x,p.y,m_tile,m_x,m_y);
+                m_w = m_tile->width();
+                m_h = m_tile->height();
+                x = p.x-m_x;
+                y = p.y-m_y;
+            }
+            return boost::gil::const_view(*m_tile)(x,y);
+        }
+    private:
+        const tiled_image *m_img;
+        mutable tile_ptr m_tile;
+        mutable std::ptrdiff_t m_x, m_y, m_w, m_h;
+    };
+    typedef boost::gil::virtual_2d_locator<deref_fn,false> locator_t;
+    typedef boost::gil::image_view<locator_t>              view_t;
+    typedef view_t                                         const_view_t;
+
+    // capacity : maximum number of tiles kept in memory
+    tiled_image(const TileSource& source, int tile_width=256, int tile_height=256, std::size_t capacity=64)
+        : m_source(source), m_tile_width(tile_width), m_tile_height(tile_height), m_capacity(capacity), m_loads(0)
+    {
+        m_width  = m_source.width ();
+        m_height = m_source.height();
+        m_tiles_x = (m_width +m_tile_width -1)/m_tile_width;
+        m_tiles_y = (m_height+m_tile_height-1)/m_tile_height;
+        m_tiles.resize(m_tiles_x*m_tiles_y);
+    }
+
+    inline int width () const { return m_width;  }
+    inline int height() const { return m_height; }
+    inline view_t view() const
+    {
+        typedef typename locator_t::point_t point_t;
+        return view_t(m_width,m_height,locator_t(point_t(0,0),point_t(1,1),deref_fn(this)));
+    }
+
+    inline std::size_t resident() const { boost::mutex::scoped_lock lock(m_mutex); return m_lru.size(); }
+    inline std::size_t loads   () const { boost::mutex::scoped_lock lock(m_mutex); return m_loads; }
+
+    // tile containing the pixel (x,y), and its origin
+    void tile_at(std::ptrdiff_t x, std::ptrdiff_t y, tile_ptr& tile, std::ptrdiff_t& x0, std::ptrdiff_t& y0) const
+    {
+        int tx = x/m_tile_width, ty = y/m_tile_height;
+        x0 = tx*m_tile_width;
+        y0 = ty*m_tile_height;
+        std::size_t k = ty*m_tiles_x+tx;
+        boost::mutex::scoped_lock lock(m_mutex);
+        entry& e = m_tiles[k];
+        if(e.m_tile) {
+            m_lru.splice(m_lru.begin(),m_lru,e.m_lru);
+        } else {
+            boost::shared_ptr<Image> t(new Image);
+            m_source.load(*t,x0,y0,std::min(m_tile_width,m_width-int(x0)),std::min(m_tile_height,m_height-int(y0)));
+            ++m_loads;
+            e.m_tile = t;
+            m_lru.push_front(k);
+            e.m_lru = m_lru.begin();
+            // views still using a dropped tile keep it alive
+            if(m_lru.size()>m_capacity) {
+                m_tiles[m_lru.back()].m_tile.reset();
+                m_lru.pop_back();
+            }
+        }
+        tile = e.m_tile;
+    }
+
+private:
+    tiled_image(const tiled_image&);
+    tiled_image& operator=(const tiled_image&);
+
+    struct entry {
+        tile_ptr m_tile;
+        std::list<std::size_t>::iterator m_lru;
+    };
+
+    TileSource m_source;
+    int m_width, m_height, m_tile_width, m_tile_height, m_tiles_x, m_tiles_y;
+    std::size_t m_capacity;
+    mutable std::vector<entry> m_tiles;
+    mutable std::list<std::size_t> m_lru; // most recently used first
+    mutable std::size_t m_loads;
+    mutable boost::mutex m_mutex;
+};
+
+#endif // TILED_IMAGE_HPP
@@ -0,0 +1,108 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+#ifndef TILED_IMAGE_INC_HPP
+#define TILED_IMAGE_INC_HPP
+
+#include <algorithm>
+#include <string>
+#include <boost/bind.hpp>
+#include <boost/gil/extension/io_new/tiff_read.hpp>
+#include "tiled_image.hpp"
+#include "image_types.hpp"
+
+// TileSource reading the tiles of a tiff file, whose pixels have the type of Image
+template<typename Image>
+class tiff_tile_source
+{
+public:
+    tiff_tile_source(const std::string& file) : m_file(file)
+    {
+        using namespace boost::gil;
+        image_read_info<tiff_tag> info = read_image_info(m_file, tiff_tag());
+        m_width  = info._width;
+        m_height = info._height;
+    }
+    inline int width () const { return m_width;  }
+    inline int height() const { return m_height; }
+    void load(Image& img, int x, int y, int w, int h) const
+    {
+        using namespace boost::gil;
+        image_read_settings<tiff_tag> irs( point_t(x,y), point_t(w,h) );
+        read_image( m_file, img, irs );
+    }
+private:
+    std::string m_file;
+    int m_width, m_height;
+};
+
+// TileSource computing the tiles of an image with a functor f(image,view) from the tiles of a tiff file,
+// such as gradient_functor : each tile is computed from the tile of the file extended by a margin
+// (the half size of the filter of f), so that the tiles are the ones of the whole image computed at once.
+template<typename Functor>
+class filtered_tile_source
+{
+public:
+    filtered_tile_source(const std::string& file, const Functor& f, int margin) : m_file(file), m_functor(f), m_margin(margin)
+    {
+        using namespace boost::gil;
+        image_read_info<tiff_tag> info = read_image_info(m_file, tiff_tag());
+        m_width  = info._width;
+        m_height = info._height;
+    }
+    inline int width () const { return m_width;  }
+    inline int height() const { return m_height; }
+    template<typename Image>
+    void load(Image& img, int x, int y, int w, int h) const
+    {
+        using namespace boost::gil;
+        int x0 = std::max(0,x-m_margin), y0 = std::max(0,y-m_margin);
+        int x1 = std::min(m_width,x+w+m_margin), y1 = std::min(m_height,y+h+m_margin);
+        rjmcmc::any_image_t in;
+        image_read_settings<tiff_tag> irs( point_t(x0,y0), point_t(x1-x0,y1-y0) );
+        read_image( m_file, in, irs );
+        Image out;
+        apply_operation( const_view(in), boost::bind(m_functor,boost::ref(out),_1) );
+        img.recreate(w,h);
+        copy_pixels( subimage_view(const_view(out),x-x0,y-y0,w,h), view(img) );
+    }
+private:
+    std::string m_file;
+    Functor m_functor;
+    int m_margin, m_width, m_height;
+};
+
+#endif // TILED_IMAGE_INC_HPP
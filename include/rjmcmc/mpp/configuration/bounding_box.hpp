@@ -0,0 +1,82 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+#ifndef BOUNDING_BOX_HPP
+#define BOUNDING_BOX_HPP
+
+#include "rjmcmc/geometry/bbox/all.hpp"
+#include "rjmcmc/util/variant.hpp" // apply_visitor
+
+namespace marked_point_process {
+
+    // double precision axis-aligned bounding box, shared by all object types (including variants)
+    struct bounding_box {
+        double xmin, ymin, xmax, ymax;
+
+        bounding_box() : xmin(0), ymin(0), xmax(0), ymax(0) {}
+        bounding_box(double x0, double y0, double x1, double y1) : xmin(x0), ymin(y0), xmax(x1), ymax(y1) {}
+
+        // closed boxes : touching boxes do intersect
+        inline bool intersects(const bounding_box& b) const {
+            return xmin<=b.xmax && b.xmin<=xmax && ymin<=b.ymax && b.ymin<=ymax;
+        }
+        inline bool contains(const bounding_box& b) const {
+            return xmin<=b.xmin && b.xmax<=xmax && ymin<=b.ymin && b.ymax<=ymax;
+        }
+        inline bounding_box dilate(double d) const {
+            return bounding_box(xmin-d,ymin-d,xmax+d,ymax+d);
+        }
+    };
+
+    struct bounding_box_functor {
+        typedef bounding_box result_type;
+        template<typename T> inline bounding_box operator()(const T& t) const { return make(geometry::bbox(t)); }
+    private:
+        template<typename Box> static inline bounding_box make(const Box& b) {
+            return bounding_box(
+                    geometry::to_double(b.min().x()), geometry::to_double(b.min().y()),
+                    geometry::to_double(b.max().x()), geometry::to_double(b.max().y()) );
+        }
+    };
+
+    template<typename T> inline bounding_box get_bounding_box(const T& t)
+    {
+        return rjmcmc::apply_visitor(bounding_box_functor(),t);
+    }
+
+}; // namespace marked_point_process
+
+#endif // BOUNDING_BOX_HPP
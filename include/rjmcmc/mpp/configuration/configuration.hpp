@@ -38,17 +38,77 @@ knowledge of the CeCILL license and that you accept its terms.
 #define RJMCMC_CONFIGURATION_HPP
 
 #include <vector>
+#include <iterator>
+#include <algorithm>
+#include <boost/type_traits/integral_constant.hpp>
 
 namespace marked_point_process {
     //////////////////////////////////////////////////////////
     
+    // An accelerator returns, for an object t, a range of candidate neighbours of t in the configuration c.
+    // Objects outside this range are assumed not to interact with t (zero binary energy).
+    // The range may be stored in a buffer provided by the caller, it is then valid until the next query using this buffer :
+    // queries do not modify the accelerator, so that a const configuration may be queried concurrently with distinct buffers.
+    // Stateful accelerators are notified of the insertion and removal of each object of the configuration.
     struct trivial_accelerator {
-	template<typename C, typename T> std::pair<typename C::iterator,typename C::iterator> operator()(const C &c, const T &t) const {
+	template<typename C, typename T, typename Buffer> std::pair<typename C::const_iterator,typename C::const_iterator> operator()(const C &c, const T &t, Buffer&) const {
             return std::make_pair(c.begin(),c.end());
 	}
+        template<typename C> inline void insert(const C &c, typename C::const_iterator it) {}
+        template<typename C> inline void remove(const C &c, typename C::const_iterator it) {}
+        inline void clear() {}
+    };
+
+    // accelerator_traits<Accelerator,Handle> gives, for an accelerator used by a configuration with iterators of type Handle :
+    // - type     : the accelerator type actually stored by the configuration (possibly rebound to Handle)
+    // - iterator : the iterator type of the candidate range
+    // - buffer   : the type of the buffer provided by the caller to each query
+    // - handle(it) : the configuration iterator referenced by an iterator of the candidate range
+    template<typename Accelerator, typename Handle> struct accelerator_traits {
+        typedef Accelerator type;
+        typedef Handle      iterator;
+        struct buffer {};
+        static inline Handle handle(iterator it) { return it; }
     };
     
+    // is_random_access_configuration<C> is true if C provides nth(i), the i-th object (0<=i<size()) in constant time.
+    // Otherwise objects are reached by advancing from begin().
+    template<typename Configuration> struct is_random_access_configuration : boost::false_type {};
+
+    template<typename Configuration>
+    inline typename Configuration::const_iterator nth(const Configuration& c, unsigned int i, boost::true_type)
+    {
+        return c.nth(i);
+    }
+    template<typename Configuration>
+    inline typename Configuration::const_iterator nth(const Configuration& c, unsigned int i, boost::false_type)
+    {
+        typename Configuration::const_iterator it = c.begin();
+        std::advance(it, i);
+        return it;
+    }
+    template<typename Configuration>
+    inline typename Configuration::const_iterator nth(const Configuration& c, unsigned int i)
+    {
+        return nth(c, i, is_random_access_configuration<Configuration>());
+    }
+
     namespace internal {
+        // key under which a stateful accelerator stores a configuration iterator :
+        // random access iterators are stored as offsets, which remain valid when the container reallocates
+        template<typename Handle, typename Category = typename std::iterator_traits<Handle>::iterator_category>
+        struct accelerator_key {
+            typedef Handle type;
+            template<typename C> static inline type encode(const C &c, Handle h) { return h; }
+            template<typename C> static inline Handle decode(const C &c, type k) { return k; }
+        };
+        template<typename Handle>
+        struct accelerator_key<Handle,std::random_access_iterator_tag> {
+            typedef std::ptrdiff_t type;
+            template<typename C> static inline type encode(const C &c, Handle h) { return h-c.begin(); }
+            template<typename C> static inline Handle decode(const C &c, type k) { return c.begin()+k; }
+        };
+
         template<typename C> struct inserter {
             C& c_;
             inserter(C& c) : c_(c) {}
@@ -88,6 +148,59 @@ namespace marked_point_process {
             death_type	m_death;
         };
 
+        // energies of the births of a modification, recorded by the delta_energy of a configuration :
+        // the unary energy of each birth, its non-zero binary energies with the surviving objects
+        // and its binary energies with the previous births of the same modification
+        template<typename Iterator>
+        struct birth_energies {
+            typedef std::vector< std::pair<Iterator,double> > binary_type;
+            std::vector<double> unary;
+            binary_type binary; // the binary energies of birth i are in [first[i],first[i+1])
+            std::vector<std::size_t> first;
+            std::vector<double> births; // energy between births i and j<i, at i*(i-1)/2+j
+            birth_energies() : first(1,0) {}
+            inline void clear() { unary.clear(); binary.clear(); first.assign(1,0); births.clear(); }
+        };
+
+        // modification that keeps the birth energies computed by delta_energy,
+        // so that apply does not evaluate them again when the modification is accepted.
+        // The configuration must provide insert(t,unary,first,last) with precomputed energies,
+        // returning the handle of the inserted object.
+        template<typename Configuration>
+        class cached_modification : public modification<Configuration>
+        {
+            typedef modification<Configuration> base;
+        public:
+            typedef birth_energies<typename Configuration::const_iterator> energies_type;
+            // the energies are reset by delta_energy, they are thus mutable
+            inline energies_type& energies() const { return m_energies; }
+
+            inline void apply(Configuration &c) const
+            {
+                std::size_t n = base::birth().size();
+                if(m_energies.unary.size()!=n) { base::apply(c); return; }
+                std::for_each(base::death().begin(),base::death().end(),internal::remover<Configuration>(c));
+                if(n==1) {
+                    c.insert(base::birth().front(),m_energies.unary.front(),m_energies.binary.begin(),m_energies.binary.end());
+                    return;
+                }
+                // the energies with the previous births need their handles, known once they are inserted
+                std::vector<typename Configuration::const_iterator> handles;
+                typename energies_type::binary_type edges;
+                for(std::size_t i=0; i<n; ++i) {
+                    edges.assign(m_energies.binary.begin()+m_energies.first[i],m_energies.binary.begin()+m_energies.first[i+1]);
+                    for(std::size_t j=0; j<i; ++j) {
+                        double e = m_energies.births[i*(i-1)/2+j];
+                        if(e!=0) edges.push_back(std::make_pair(handles[j],e));
+                    }
+                    handles.push_back(c.insert(base::birth()[i],m_energies.unary[i],edges.begin(),edges.end()));
+                }
+            }
+
+        private:
+            mutable energies_type m_energies;
+        };
+
     }; // namespace internal
 
 }; // namespace marked_point_process
@@ -0,0 +1,465 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+#ifndef FLAT_GRAPH_CONFIGURATION_HPP
+#define FLAT_GRAPH_CONFIGURATION_HPP
+
+#include <vector>
+#include <limits>
+#include <boost/iterator/iterator_facade.hpp>
+#include <boost/tuple/tuple.hpp> // tie
+#include "configuration.hpp"
+#include "interaction_pipeline.hpp"
+#include "rjmcmc/util/variant.hpp" // apply_visitor
+
+
+namespace marked_point_process {
+
+    // Same interface and behaviour as graph_configuration, with a flat storage :
+    // objects live in a contiguous slot array whose free slots are recycled, each slot holding the object,
+    // its unary energy and a compact array of its interactions (neighbour slot and binary energy).
+    // Iterators are stable slot indices, and nth(i) gives a uniform random access to the objects in O(1).
+    template<typename T, typename UnaryEnergy, typename BinaryEnergy, typename Accelerator=trivial_accelerator>
+    class flat_graph_configuration
+    {
+    public:
+	typedef flat_graph_configuration<T,UnaryEnergy, BinaryEnergy, Accelerator> self;
+        typedef T	value_type;
+    private:
+        struct edge {
+            unsigned int m_target;
+            double m_energy;
+            edge(unsigned int target, double e) : m_target(target), m_energy(e) {}
+            inline double energy() const { return m_energy; }
+        };
+        typedef std::vector<edge> adjacency_type;
+
+        struct slot {
+            value_type m_value;
+            double m_energy;
+            bounding_box m_bbox; // cached for the interaction pipeline
+            unsigned int m_rank; // position in m_live, or dead
+            adjacency_type m_edges;
+            enum { dead = unsigned(-1) };
+            slot() : m_energy(0), m_rank(dead) {}
+            inline bool alive() const { return m_rank!=dead; }
+        };
+        typedef std::vector<slot> slot_container;
+
+    public:
+        class const_iterator : public boost::iterator_facade<const_iterator, const value_type, boost::forward_traversal_tag>
+        {
+        public:
+            const_iterator() : m_slots(0), m_i(0) {}
+            inline unsigned int index() const { return m_i; }
+        private:
+            friend class flat_graph_configuration;
+            friend class boost::iterator_core_access;
+            // points to the first living slot at or after i
+            const_iterator(const slot_container *s, unsigned int i) : m_slots(s), m_i(i) { skip(); }
+            // i is a living slot
+            const_iterator(const slot_container *s, unsigned int i, bool) : m_slots(s), m_i(i) {}
+            inline void skip() { while(m_i<m_slots->size() && !(*m_slots)[m_i].alive()) ++m_i; }
+            inline void increment() { ++m_i; skip(); }
+            inline bool equal(const const_iterator& it) const { return m_i==it.m_i; }
+            inline const value_type& dereference() const { return (*m_slots)[m_i].m_value; }
+            const slot_container *m_slots;
+            unsigned int m_i;
+        };
+        typedef const_iterator iterator;
+
+        // each interaction is visited once, from its lowest slot
+        class const_edge_iterator : public boost::iterator_facade<const_edge_iterator, const edge, boost::forward_traversal_tag>
+        {
+        public:
+            const_edge_iterator() : m_slots(0), m_i(0), m_k(0) {}
+        private:
+            friend class flat_graph_configuration;
+            friend class boost::iterator_core_access;
+            const_edge_iterator(const slot_container *s, unsigned int i) : m_slots(s), m_i(i), m_k(0) { skip(); }
+            inline void skip() {
+                for(; m_i<m_slots->size(); ++m_i, m_k=0) {
+                    const adjacency_type& a = (*m_slots)[m_i].m_edges;
+                    for(; m_k<a.size(); ++m_k)
+                        if(a[m_k].m_target>m_i) return;
+                }
+            }
+            inline void increment() { ++m_k; skip(); }
+            inline bool equal(const const_edge_iterator& it) const { return m_i==it.m_i && m_k==it.m_k; }
+            inline const edge& dereference() const { return (*m_slots)[m_i].m_edges[m_k]; }
+            const slot_container *m_slots;
+            unsigned int m_i, m_k;
+        };
+        typedef const_edge_iterator edge_iterator;
+        typedef internal::cached_modification<self>     modification;
+    private:
+        typedef accelerator_traits<Accelerator,const_iterator> accelerator_traits_type;
+        typedef typename accelerator_traits_type::type      accelerator_type;
+        typedef typename accelerator_traits_type::iterator  accelerator_iterator;
+        typedef typename accelerator_traits_type::buffer    accelerator_buffer;
+    public:
+
+	// configuration constructors/destructors
+	flat_graph_configuration(UnaryEnergy unary_energy, BinaryEnergy binary_energy, Accelerator accelerator=Accelerator())
+            : m_unary(0.), m_binary(0.), m_num_edges(0), m_unary_energy(unary_energy), m_interactions(binary_energy), m_accelerator(accelerator)
+	{}
+	// iterators refer to their configuration, the accelerator is thus rebuilt
+	flat_graph_configuration(const flat_graph_configuration& c)
+            : m_unary(c.m_unary), m_binary(c.m_binary), m_num_edges(c.m_num_edges), m_slots(c.m_slots), m_free(c.m_free), m_live(c.m_live)
+            , m_unary_energy(c.m_unary_energy), m_interactions(c.m_interactions), m_statistics(c.m_statistics), m_accelerator(c.m_accelerator)
+	{
+            rebuild_accelerator();
+	}
+	flat_graph_configuration& operator=(const flat_graph_configuration& c)
+	{
+            if(this==&c) return *this;
+            m_unary = c.m_unary;
+            m_binary = c.m_binary;
+            m_num_edges = c.m_num_edges;
+            m_slots = c.m_slots;
+            m_free = c.m_free;
+            m_live = c.m_live;
+            m_unary_energy = c.m_unary_energy;
+            m_interactions = c.m_interactions;
+            m_statistics = c.m_statistics;
+            m_accelerator = c.m_accelerator;
+            rebuild_accelerator();
+            return *this;
+	}
+	~flat_graph_configuration()
+	{}
+
+	// configuration accessors
+	inline double unary_energy () const { return m_unary;}
+	inline double binary_energy() const { return m_binary;}
+	inline double energy       () const {
+            return unary_energy()+binary_energy();
+	}
+	inline const UnaryEnergy & unary_energy_functor () const { return m_unary_energy; }
+	inline const BinaryEnergy& binary_energy_functor() const { return m_interactions.energy(); }
+	// number of binary energy evaluations by the evaluators and manipulators, audits excluded
+	inline unsigned long binary_evaluations() const { return m_statistics.evaluated; }
+	// number of unary energy evaluations by the non-const evaluators and the manipulators, audits excluded
+	inline unsigned long unary_evaluations() const { return m_statistics.unary; }
+	// candidate pairs pruned by each stage of the interaction pipeline
+	inline const interaction_statistics& pruning_statistics() const { return m_statistics; }
+
+	// values
+	inline size_t size() const { return m_live.size(); }
+	inline bool empty() const { return m_live.empty(); }
+	inline const_iterator begin() const { return const_iterator(&m_slots,0); }
+        inline const_iterator end  () const { return const_iterator(&m_slots,m_slots.size(),true); }
+	// i-th object, in an arbitrary order, 0<=i<size()
+	inline const_iterator nth(size_t i) const { return const_iterator(&m_slots,m_live[i],true); }
+	inline const value_type& value( const_iterator v ) const { return m_slots[v.index()].m_value; }
+	inline double energy( const_iterator v ) const { return m_slots[v.index()].m_energy; }
+
+	// interactions
+	inline size_t size_of_interactions   () const { return m_num_edges; }
+	inline const_edge_iterator interactions_begin() const { return const_edge_iterator(&m_slots,0); }
+	inline const_edge_iterator interactions_end  () const { return const_edge_iterator(&m_slots,m_slots.size()); }
+	inline double energy( const_edge_iterator e ) const { return e->energy(); }
+
+	// evaluators
+	// the const evaluators may be called concurrently, they count the energy evaluations in s or not at all.
+	// The non-const ones, called by the samplers, count them in pruning_statistics().
+
+	template <typename Modification> double delta_energy(const Modification &modif, interaction_statistics& s) const
+	{
+            return delta_birth(modif,s)+delta_death(modif);
+	}
+	template <typename Modification> double delta_energy(const Modification &modif) const
+	{
+            interaction_statistics s;
+            return delta_energy(modif,s);
+	}
+	template <typename Modification> double delta_energy(const Modification &modif)
+	{
+            return delta_energy(modif,m_statistics);
+	}
+
+	// delta_energy, or a lower bound of it greater than max_delta as soon as it is known to exceed max_delta.
+	// The evaluation stops early only if the binary energy is non-negative.
+	template <typename Modification> double delta_energy(const Modification &modif, double max_delta, interaction_statistics& s) const
+	{
+            if(!m_interactions.non_negative()) return delta_energy(modif,s);
+            return delta_birth(modif,s,delta_death(modif),max_delta);
+	}
+	template <typename Modification> double delta_energy(const Modification &modif, double max_delta) const
+	{
+            interaction_statistics s;
+            return delta_energy(modif,max_delta,s);
+	}
+	template <typename Modification> double delta_energy(const Modification &modif, double max_delta)
+	{
+            return delta_energy(modif,max_delta,m_statistics);
+	}
+
+	// returns delta plus the energy of the births, the binary energies are evaluated last
+	// and their evaluation stops as soon as the sum exceeds max_delta
+	template <typename Modification> double delta_birth(const Modification &modif, interaction_statistics& s, double delta=0,
+                                                            double max_delta=std::numeric_limits<double>::infinity()) const
+	{
+            typedef typename Modification::birth_type::const_iterator bci;
+            typedef typename Modification::death_type::const_iterator dci;
+            bci bbeg = modif.birth().begin();
+            bci bend = modif.birth().end();
+            dci dbeg = modif.death().begin();
+            dci dend = modif.death().end();
+            // the energies are recorded for Modification::apply, they are cleared if the evaluation stops early
+            typename Modification::energies_type& energies = modif.energies();
+            energies.clear();
+            accelerator_buffer buffer;
+            for(bci it=bbeg; it!=bend; ++it) {
+                double u = rjmcmc::apply_visitor(m_unary_energy,*it);
+                energies.unary.push_back(u);
+                delta += u;
+                ++s.unary;
+            }
+            for(bci it=bbeg; it!=bend; ++it) {
+                bounding_box b = m_interactions.box(*it);
+                accelerator_iterator it2, end2;
+                boost::tie(it2,end2)=m_accelerator(*this,*it,buffer);
+                for (; it2 != end2; ++it2) {
+                    const_iterator v = accelerator_traits_type::handle(it2);
+                    if (std::find(dbeg,dend,v)==dend) {
+                        double e = m_interactions(*it, b, value(v), m_slots[v.index()].m_bbox, s);
+                        if (e != 0) energies.binary.push_back(std::make_pair(v,e));
+                        delta += e;
+                        if (delta > max_delta) { energies.clear(); return delta; }
+                    }
+                }
+                energies.first.push_back(energies.binary.size());
+                for (bci it2=bbeg; it2 != it; ++it2) {
+                    double e = m_interactions(*it, *it2, s);
+                    energies.births.push_back(e);
+                    delta += e;
+                    if (delta > max_delta) { energies.clear(); return delta; }
+                }
+            }
+            return delta;
+	}
+
+	template <typename Modification> double delta_death(const Modification &modif) const
+	{
+            double delta = 0;
+            typedef typename Modification::death_type::const_iterator dci;
+            dci dbeg = modif.death().begin();
+            dci dend = modif.death().end();
+            for(dci it=dbeg; it!=dend; ++it) {
+                const slot& s = m_slots[it->index()];
+                delta -= s.m_energy;
+                for(typename adjacency_type::const_iterator e=s.m_edges.begin(); e!=s.m_edges.end(); ++e) {
+                    bool found = false;
+                    for(dci it3=dbeg; it3!=it && !found; ++it3)
+                        found = (it3->index() == e->m_target);
+                    if (!found)
+                        delta -= e->m_energy;
+                }
+            }
+            return delta;
+        }
+
+	// manipulators
+	inline void insert(const value_type& obj)
+	{
+            ++m_statistics.unary;
+            insert(obj, rjmcmc::apply_visitor(m_unary_energy,obj));
+	}
+
+	// inserts obj, given its unary energy
+	void insert(const value_type& obj, double unary)
+	{
+            unsigned int i = new_slot(obj, unary);
+            bounding_box b = m_slots[i].m_bbox;
+            // slot i is not alive yet, it is thus not a candidate
+            accelerator_buffer buffer;
+            accelerator_iterator it, end;
+            for (boost::tie(it,end)=m_accelerator(*this,obj,buffer); it != end; ++it) {
+                const_iterator v = accelerator_traits_type::handle(it);
+                double e = m_interactions(obj, b, value(v), m_slots[v.index()].m_bbox, m_statistics);
+                if (   e == 0 ) continue;
+                add_edge(i, v.index(), e);
+            }
+            make_alive(i);
+	}
+
+	// inserts obj, given its unary energy and its non-zero binary energies with the objects of the configuration,
+	// as a range of (const_iterator,double) pairs, and returns its handle
+	template<typename InputIterator>
+	const_iterator insert(const value_type& obj, double unary, InputIterator first, InputIterator last)
+	{
+            unsigned int i = new_slot(obj, unary);
+            for (; first != last; ++first)
+                add_edge(i, first->first.index(), first->second);
+            make_alive(i);
+            return const_iterator(&m_slots,i,true);
+	}
+
+        template<typename F> inline void for_each(F f) const {
+            for(std::vector<unsigned int>::const_iterator it=m_live.begin(); it!=m_live.end(); ++it)
+                rjmcmc::apply_visitor(f,m_slots[*it].m_value);
+        }
+
+	void remove( const_iterator v )
+	{
+            m_accelerator.remove(*this,v);
+            unsigned int i = v.index();
+            slot& s = m_slots[i];
+            for(typename adjacency_type::const_iterator e=s.m_edges.begin(); e!=s.m_edges.end(); ++e) {
+                adjacency_type& a = m_slots[e->m_target].m_edges;
+                for(typename adjacency_type::iterator it=a.begin(); it!=a.end(); ++it) {
+                    if(it->m_target==i) {
+                        *it = a.back();
+                        a.pop_back();
+                        break;
+                    }
+                }
+                m_binary -= e->m_energy;
+                --m_num_edges;
+            }
+            s.m_edges.clear();
+            m_unary -= s.m_energy;
+            // the last living slot takes the rank of the removed one
+            unsigned int last = m_live.back();
+            m_live[s.m_rank] = last;
+            m_slots[last].m_rank = s.m_rank;
+            m_live.pop_back();
+            s.m_rank = slot::dead;
+            m_free.push_back(i);
+	}
+
+	inline void clear() { m_accelerator.clear(); m_slots.clear(); m_free.clear(); m_live.clear(); m_num_edges=0; m_unary=m_binary=0; }
+
+	// audit
+	double audit_unary_energy() const
+	{
+            double e = 0.;
+            for (const_iterator i=begin(); i != end(); ++i)
+                e += rjmcmc::apply_visitor(m_unary_energy, value(i) );
+            return e;
+	}
+
+	double audit_binary_energy() const
+	{
+            double e = 0.;
+            for (const_iterator i=begin(); i != end(); ++i) {
+                const adjacency_type& a = m_slots[i.index()].m_edges;
+                for(typename adjacency_type::const_iterator it=a.begin(); it!=a.end(); ++it)
+                    if(it->m_target>i.index())
+                        e += rjmcmc::apply_visitor(m_interactions.energy(), value(i), m_slots[it->m_target].m_value );
+            }
+            return e;
+	}
+
+	unsigned int audit_structure() const
+	{
+            unsigned int err = 0;
+            for (const_iterator i=begin(); i != end(); ++i)
+            {
+                const_iterator j = i;
+                for (++j; j != end(); ++j)
+                {
+                    bool computed = (0!= rjmcmc::apply_visitor(m_interactions.energy(),value(i), value(j)));
+                    bool stored = false;
+                    const adjacency_type& a = m_slots[i.index()].m_edges;
+                    for(typename adjacency_type::const_iterator it=a.begin(); it!=a.end() && !stored; ++it)
+                        stored = (it->m_target==j.index());
+                    if (computed != stored)	++err;
+                }
+            }
+            return err;
+	}
+
+    private:
+        unsigned int new_slot(const value_type& obj, double unary)
+        {
+            unsigned int i;
+            if(m_free.empty()) {
+                i = m_slots.size();
+                m_slots.push_back(slot());
+            } else {
+                i = m_free.back();
+                m_free.pop_back();
+            }
+            slot& s = m_slots[i];
+            s.m_value  = obj;
+            s.m_energy = unary;
+            s.m_bbox   = m_interactions.box(obj);
+            m_unary += unary;
+            return i;
+        }
+
+        inline void add_edge(unsigned int i, unsigned int j, double e)
+        {
+            m_slots[i].m_edges.push_back(edge(j,e));
+            m_slots[j].m_edges.push_back(edge(i,e));
+            m_binary += e;
+            ++m_num_edges;
+        }
+
+        void make_alive(unsigned int i)
+        {
+            m_slots[i].m_rank = m_live.size();
+            m_live.push_back(i);
+            m_accelerator.insert(*this,const_iterator(&m_slots,i,true));
+        }
+
+        void rebuild_accelerator()
+        {
+            m_accelerator.clear();
+            for (const_iterator i=begin(); i != end(); ++i)
+                m_accelerator.insert(*this,i);
+        }
+
+        double m_unary;
+        double m_binary;
+        size_t m_num_edges;
+        slot_container m_slots;
+        std::vector<unsigned int> m_free; // dead slots
+        std::vector<unsigned int> m_live; // living slots
+	UnaryEnergy	m_unary_energy;
+	interaction_pipeline<BinaryEnergy>	m_interactions;
+	interaction_statistics	m_statistics;
+        accelerator_type	m_accelerator;
+    };
+
+    template<typename T, typename U, typename B, typename A>
+    struct is_random_access_configuration< flat_graph_configuration<T,U,B,A> > : boost::true_type {};
+
+}; // namespace marked_point_process
+
+#endif // FLAT_GRAPH_CONFIGURATION_HPP
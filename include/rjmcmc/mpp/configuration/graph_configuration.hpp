@@ -38,7 +38,10 @@ knowledge of the CeCILL license and that you accept its terms.
 #define GRAPH_CONFIGURATION_HPP
 
 #include <boost/graph/adjacency_list.hpp>
+#include <boost/next_prior.hpp>
+#include <limits>
 #include "configuration.hpp"
+#include "interaction_pipeline.hpp"
 #include "rjmcmc/util/variant.hpp" // apply_visitor
 
 
@@ -63,13 +66,16 @@ namespace marked_point_process {
 
 	class node {
 	public:
-            node(const value_type& obj, double e) : m_value(obj), m_energy(e) { }
+            node() : m_energy(0) { }
+            node(const value_type& obj, double e, const bounding_box& b) : m_value(obj), m_energy(e), m_bbox(b) { }
             inline const value_type& value() const { return m_value; }
             inline double energy() const { return m_energy; }
+            inline const bounding_box& bbox() const { return m_bbox; }
 
 	private:
             value_type	m_value;
             double	m_energy;
+            bounding_box	m_bbox; // cached for the interaction pipeline
 	};
 	typedef boost::adjacency_list<OutEdgeList, VertexList, boost::undirectedS, node, edge> graph_type;
 	typedef typename graph_type::out_edge_iterator	out_edge_iterator;
@@ -81,12 +87,35 @@ namespace marked_point_process {
 	typedef	typename graph_type::vertex_iterator	const_iterator;
 	typedef typename graph_type::edge_iterator	edge_iterator;
 	typedef typename graph_type::edge_iterator	const_edge_iterator;
-        typedef internal::modification<self>            modification;
+        typedef internal::cached_modification<self>     modification;
+    private:
+        typedef accelerator_traits<Accelerator,const_iterator> accelerator_traits_type;
+        typedef typename accelerator_traits_type::type      accelerator_type;
+        typedef typename accelerator_traits_type::iterator  accelerator_iterator;
+        typedef typename accelerator_traits_type::buffer    accelerator_buffer;
     public:
 
 	// configuration constructors/destructors
-	graph_configuration(UnaryEnergy unary_energy, BinaryEnergy binary_energy, Accelerator accelerator=Accelerator()) : m_unary(0.), m_binary(0.), m_unary_energy(unary_energy), m_binary_energy(binary_energy), m_accelerator(accelerator)
+	graph_configuration(UnaryEnergy unary_energy, BinaryEnergy binary_energy, Accelerator accelerator=Accelerator()) : m_unary(0.), m_binary(0.), m_unary_energy(unary_energy), m_interactions(binary_energy), m_accelerator(accelerator)
 	{}
+	// vertex handles are not preserved by the copy, the accelerator is thus rebuilt
+	graph_configuration(const graph_configuration& c) : m_unary(c.m_unary), m_binary(c.m_binary), m_graph(c.m_graph), m_unary_energy(c.m_unary_energy), m_interactions(c.m_interactions), m_statistics(c.m_statistics), m_accelerator(c.m_accelerator)
+	{
+            rebuild_accelerator();
+	}
+	graph_configuration& operator=(const graph_configuration& c)
+	{
+            if(this==&c) return *this;
+            m_unary = c.m_unary;
+            m_binary = c.m_binary;
+            m_graph = c.m_graph;
+            m_unary_energy = c.m_unary_energy;
+            m_interactions = c.m_interactions;
+            m_statistics = c.m_statistics;
+            m_accelerator = c.m_accelerator;
+            rebuild_accelerator();
+            return *this;
+	}
 	~graph_configuration()
 	{}
 
@@ -96,6 +125,14 @@ namespace marked_point_process {
 	inline double energy       () const {
             return unary_energy()+binary_energy();
 	}
+	inline const UnaryEnergy & unary_energy_functor () const { return m_unary_energy; }
+	inline const BinaryEnergy& binary_energy_functor() const { return m_interactions.energy(); }
+	// number of binary energy evaluations by the non-const evaluators and the manipulators, audits excluded
+	inline unsigned long binary_evaluations() const { return m_statistics.evaluated; }
+	// number of unary energy evaluations by the non-const evaluators and the manipulators, audits excluded
+	inline unsigned long unary_evaluations() const { return m_statistics.unary; }
+	// candidate pairs pruned by each stage of the interaction pipeline
+	inline const interaction_statistics& pruning_statistics() const { return m_statistics; }
 
 	// values
 	inline size_t size() const { return num_vertices(m_graph); }
@@ -116,30 +153,81 @@ namespace marked_point_process {
 	inline double energy( edge_iterator e ) const { return m_graph[ *e ].energy(); }
 
 	// evaluators
+	// the const evaluators may be called concurrently, they count the energy evaluations in s or not at all.
+	// The non-const ones, called by the samplers, count them in pruning_statistics().
 
+	template <typename Modification> double delta_energy(const Modification &modif, interaction_statistics& s) const
+	{
+            return delta_birth(modif,s)+delta_death(modif);
+	}
 	template <typename Modification> double delta_energy(const Modification &modif) const
 	{
-            return delta_birth(modif)+delta_death(modif);
+            interaction_statistics s;
+            return delta_energy(modif,s);
+	}
+	template <typename Modification> double delta_energy(const Modification &modif)
+	{
+            return delta_energy(modif,m_statistics);
 	}
 
-	template <typename Modification> double delta_birth(const Modification &modif) const
+	// delta_energy, or a lower bound of it greater than max_delta as soon as it is known to exceed max_delta.
+	// The evaluation stops early only if the binary energy is non-negative.
+	template <typename Modification> double delta_energy(const Modification &modif, double max_delta, interaction_statistics& s) const
+	{
+            if(!m_interactions.non_negative()) return delta_energy(modif,s);
+            return delta_birth(modif,s,delta_death(modif),max_delta);
+	}
+	template <typename Modification> double delta_energy(const Modification &modif, double max_delta) const
+	{
+            interaction_statistics s;
+            return delta_energy(modif,max_delta,s);
+	}
+	template <typename Modification> double delta_energy(const Modification &modif, double max_delta)
+	{
+            return delta_energy(modif,max_delta,m_statistics);
+	}
+
+	// returns delta plus the energy of the births, the binary energies are evaluated last
+	// and their evaluation stops as soon as the sum exceeds max_delta
+	template <typename Modification> double delta_birth(const Modification &modif, interaction_statistics& s, double delta=0,
+                                                            double max_delta=std::numeric_limits<double>::infinity()) const
 	{
-            double delta = 0;
             typedef typename Modification::birth_type::const_iterator bci;
             typedef typename Modification::death_type::const_iterator dci;
             bci bbeg = modif.birth().begin();
             bci bend = modif.birth().end();
             dci dbeg = modif.death().begin();
             dci dend = modif.death().end();
+            // the energies are recorded for Modification::apply, they are cleared if the evaluation stops early
+            typename Modification::energies_type& energies = modif.energies();
+            energies.clear();
+            accelerator_buffer buffer;
             for(bci it=bbeg; it!=bend; ++it) {
-                delta += rjmcmc::apply_visitor(m_unary_energy,*it);
-                const_iterator   it2, end2;
-                boost::tie(it2,end2)=m_accelerator(*this,*it);
-                for (; it2 != end2; ++it2)
-                    if (std::find(dbeg,dend,it2)==dend)
-                        delta += rjmcmc::apply_visitor(m_binary_energy, *it, value(it2) );
-                for (bci it2=bbeg; it2 != it; ++it2)
-                    delta += rjmcmc::apply_visitor(m_binary_energy, *it, *it2);
+                double u = rjmcmc::apply_visitor(m_unary_energy,*it);
+                energies.unary.push_back(u);
+                delta += u;
+                ++s.unary;
+            }
+            for(bci it=bbeg; it!=bend; ++it) {
+                bounding_box b = m_interactions.box(*it);
+                accelerator_iterator it2, end2;
+                boost::tie(it2,end2)=m_accelerator(*this,*it,buffer);
+                for (; it2 != end2; ++it2) {
+                    const_iterator v = accelerator_traits_type::handle(it2);
+                    if (std::find(dbeg,dend,v)==dend) {
+                        double e = m_interactions(*it, b, value(v), m_graph[*v].bbox(), s);
+                        if (e != 0) energies.binary.push_back(std::make_pair(v,e));
+                        delta += e;
+                        if (delta > max_delta) { energies.clear(); return delta; }
+                    }
+                }
+                energies.first.push_back(energies.binary.size());
+                for (bci it2=bbeg; it2 != it; ++it2) {
+                    double e = m_interactions(*it, *it2, s);
+                    energies.births.push_back(e);
+                    delta += e;
+                    if (delta > max_delta) { energies.clear(); return delta; }
+                }
             }
             return delta;
 	}
@@ -167,21 +255,51 @@ namespace marked_point_process {
         }
 
 	// manipulators
-	void insert(const value_type& obj)
+	inline void insert(const value_type& obj)
 	{
-            node n(obj, rjmcmc::apply_visitor(m_unary_energy,obj));
+            ++m_statistics.unary;
+            insert(obj, rjmcmc::apply_visitor(m_unary_energy,obj));
+	}
+
+	// inserts obj, given its unary energy
+	void insert(const value_type& obj, double unary)
+	{
+            node n(obj, unary, m_interactions.box(obj));
             m_unary += n.energy();
             vertex_descriptor d = add_vertex(n, m_graph);
-            iterator   it, end;
+            accelerator_buffer buffer;
+            accelerator_iterator it, end;
 
-            for (boost::tie(it,end)=m_accelerator(*this,obj); it != end; ++it) {
-                if ( *it == d ) continue;
-                double e = rjmcmc::apply_visitor(m_binary_energy, obj, value(it) );
+            for (boost::tie(it,end)=m_accelerator(*this,obj,buffer); it != end; ++it) {
+                const_iterator v = accelerator_traits_type::handle(it);
+                if ( *v == d ) continue;
+                double e = m_interactions(obj, n.bbox(), value(v), m_graph[*v].bbox(), m_statistics);
                 if (   e == 0 ) continue;
-                edge_descriptor_bool new_edge = add_edge(d, *it, m_graph );
+                edge_descriptor_bool new_edge = add_edge(d, *v, m_graph );
                 m_graph[ new_edge.first ].energy( e );
                 m_binary += e;
             }
+            // the new vertex is the last one
+            m_accelerator.insert(*this,boost::prior(vertices(m_graph).second));
+	}
+
+	// inserts obj, given its unary energy and its non-zero binary energies with the objects of the configuration,
+	// as a range of (const_iterator,double) pairs, and returns its handle
+	template<typename InputIterator>
+	const_iterator insert(const value_type& obj, double unary, InputIterator first, InputIterator last)
+	{
+            node n(obj, unary, m_interactions.box(obj));
+            m_unary += n.energy();
+            vertex_descriptor d = add_vertex(n, m_graph);
+            for (; first != last; ++first) {
+                edge_descriptor_bool new_edge = add_edge(d, *(first->first), m_graph );
+                m_graph[ new_edge.first ].energy( first->second );
+                m_binary += first->second;
+            }
+            // the new vertex is the last one
+            const_iterator v = boost::prior(vertices(m_graph).second);
+            m_accelerator.insert(*this,v);
+            return v;
 	}
 
         template<typename F>
@@ -209,6 +327,7 @@ namespace marked_point_process {
 
 	void remove( iterator v )
 	{
+            m_accelerator.remove(*this,v);
             out_edge_iterator it, end;
             for(boost::tie(it,end) = out_edges( *v, m_graph ); it!=end; ++it)
                 m_binary -= m_graph[ *it ].energy();
@@ -217,7 +336,7 @@ namespace marked_point_process {
             remove_vertex( *v , m_graph);
 	}
 
-	inline void clear() { m_graph.clear(); m_unary=m_binary=0; }
+	inline void clear() { m_accelerator.clear(); m_graph.clear(); m_unary=m_binary=0; }
 
 	// audit
 	double audit_unary_energy() const
@@ -233,7 +352,7 @@ namespace marked_point_process {
             double e = 0.;
             const_edge_iterator it, end;
             for(boost::tie(it,end) = edges( m_graph ); it!=end; ++it)
-                e += rjmcmc::apply_visitor(m_binary_energy,	m_graph[source(*it,m_graph)].value() ,
+                e += rjmcmc::apply_visitor(m_interactions.energy(),	m_graph[source(*it,m_graph)].value() ,
                                            m_graph[target(*it,m_graph)].value() );
             return e;
 	}
@@ -246,7 +365,7 @@ namespace marked_point_process {
                 const_iterator j = i;
                 for (++j; j != end(); ++j)
                 {
-                    bool computed = (0!= rjmcmc::apply_visitor(m_binary_energy,value(i), value(j)));
+                    bool computed = (0!= rjmcmc::apply_visitor(m_interactions.energy(),value(i), value(j)));
                     bool stored = boost::edge(*i, *j, m_graph).second;
                     if (computed != stored)	++err;
                 }
@@ -255,12 +374,20 @@ namespace marked_point_process {
 	}
 
     private:
+        void rebuild_accelerator()
+        {
+            m_accelerator.clear();
+            for (const_iterator i=begin(); i != end(); ++i)
+                m_accelerator.insert(*this,i);
+        }
+
         double m_unary;
         double m_binary;
 	graph_type m_graph;
 	UnaryEnergy	m_unary_energy;
-	BinaryEnergy	m_binary_energy;
-        Accelerator	m_accelerator;
+	interaction_pipeline<BinaryEnergy>	m_interactions;
+	interaction_statistics	m_statistics;
+        accelerator_type	m_accelerator;
     };
 
 }; // namespace marked_point_process
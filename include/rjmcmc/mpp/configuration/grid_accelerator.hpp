@@ -0,0 +1,184 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+#ifndef GRID_ACCELERATOR_HPP
+#define GRID_ACCELERATOR_HPP
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include "configuration.hpp"
+#include "bounding_box.hpp"
+
+namespace marked_point_process {
+
+    // Uniform grid accelerator : each object of the configuration is registered in the grid cells overlapped by its bounding box.
+    // The neighbour candidates of an object are the registered objects whose bounding box intersects its own bounding box,
+    // dilated by the margin. This is exact as long as objects farther apart than the margin do not interact
+    // (margin=0 is suitable for intersection-based binary energies).
+    // Objects outside the grid extent are registered in the border cells, so the extent only affects performance.
+    // The configuration notifies the accelerator of every change of its iterators (see vector_configuration::remove).
+    class grid_accelerator {
+    public:
+        grid_accelerator(double xmin, double ymin, double xmax, double ymax, double cell_size, double margin=0)
+            : m_bbox(xmin,ymin,xmax,ymax), m_cell_size(cell_size), m_margin(margin) {}
+        grid_accelerator(const bounding_box& bbox, double cell_size, double margin=0)
+            : m_bbox(bbox), m_cell_size(cell_size), m_margin(margin) {}
+
+        inline const bounding_box& bbox() const { return m_bbox; }
+        inline double cell_size() const { return m_cell_size; }
+        inline double margin() const { return m_margin; }
+
+    private:
+        bounding_box m_bbox;
+        double m_cell_size;
+        double m_margin;
+    };
+
+    namespace internal {
+
+        // grid_accelerator rebound to the handle type of the configuration
+        template<typename Handle>
+        class grid_accelerator_impl {
+            typedef accelerator_key<Handle> key;
+            typedef typename key::type key_type;
+            struct entry {
+                key_type m_key;
+                int m_i, m_j; // lowest cell overlapped by m_bbox
+                bounding_box m_bbox;
+                entry(key_type k, int i, int j, const bounding_box& b) : m_key(k), m_i(i), m_j(j), m_bbox(b) {}
+            };
+            typedef std::vector<entry> cell_type;
+
+        public:
+            typedef std::vector<Handle> buffer;
+            typedef typename buffer::const_iterator iterator;
+
+            grid_accelerator_impl(const grid_accelerator& g)
+                : m_x0(g.bbox().xmin), m_y0(g.bbox().ymin), m_cell_size(g.cell_size()), m_margin(g.margin())
+            {
+                m_nx = std::max(1,int(std::ceil((g.bbox().xmax-m_x0)/m_cell_size)));
+                m_ny = std::max(1,int(std::ceil((g.bbox().ymax-m_y0)/m_cell_size)));
+                m_cells.resize(m_nx*m_ny);
+            }
+
+            // candidates are reported once, in the lowest cell overlapped both by the query and by the candidate
+            template<typename C, typename T> std::pair<iterator,iterator> operator()(const C &c, const T &t, buffer& result) const
+            {
+                result.clear();
+                bounding_box b = get_bounding_box(t).dilate(m_margin);
+                int i0, j0, i1, j1;
+                cells(b,i0,j0,i1,j1);
+                for(int j=j0; j<=j1; ++j) {
+                    for(int i=i0; i<=i1; ++i) {
+                        const cell_type& cell = m_cells[i+m_nx*j];
+                        for(typename cell_type::const_iterator it=cell.begin(); it!=cell.end(); ++it) {
+                            if(std::max(it->m_i,i0)==i && std::max(it->m_j,j0)==j && it->m_bbox.intersects(b))
+                                result.push_back(key::decode(c,it->m_key));
+                        }
+                    }
+                }
+                return std::make_pair(result.begin(),result.end());
+            }
+
+            template<typename C> void insert(const C &c, Handle h)
+            {
+                bounding_box b = get_bounding_box(c.value(h));
+                int i0, j0, i1, j1;
+                cells(b,i0,j0,i1,j1);
+                entry e(key::encode(c,h),i0,j0,b);
+                for(int j=j0; j<=j1; ++j)
+                    for(int i=i0; i<=i1; ++i)
+                        m_cells[i+m_nx*j].push_back(e);
+            }
+
+            template<typename C> void remove(const C &c, Handle h)
+            {
+                bounding_box b = get_bounding_box(c.value(h));
+                int i0, j0, i1, j1;
+                cells(b,i0,j0,i1,j1);
+                key_type k = key::encode(c,h);
+                for(int j=j0; j<=j1; ++j) {
+                    for(int i=i0; i<=i1; ++i) {
+                        cell_type& cell = m_cells[i+m_nx*j];
+                        for(typename cell_type::iterator it=cell.begin(); it!=cell.end(); ++it) {
+                            if(it->m_key==k) {
+                                *it = cell.back();
+                                cell.pop_back();
+                                break;
+                            }
+                        }
+                    }
+                }
+            }
+
+            void clear()
+            {
+                for(typename std::vector<cell_type>::iterator it=m_cells.begin(); it!=m_cells.end(); ++it)
+                    it->clear();
+            }
+
+        private:
+            inline int cell_x(double x) const {
+                double i = std::floor((x-m_x0)/m_cell_size);
+                return (i<0) ? 0 : ((i>=m_nx) ? m_nx-1 : int(i));
+            }
+            inline int cell_y(double y) const {
+                double j = std::floor((y-m_y0)/m_cell_size);
+                return (j<0) ? 0 : ((j>=m_ny) ? m_ny-1 : int(j));
+            }
+            inline void cells(const bounding_box& b, int& i0, int& j0, int& i1, int& j1) const {
+                i0 = cell_x(b.xmin); i1 = cell_x(b.xmax);
+                j0 = cell_y(b.ymin); j1 = cell_y(b.ymax);
+            }
+
+            double m_x0, m_y0, m_cell_size, m_margin;
+            int m_nx, m_ny;
+            std::vector<cell_type> m_cells;
+        };
+
+    }; // namespace internal
+
+    template<typename Handle> struct accelerator_traits<grid_accelerator,Handle> {
+        typedef internal::grid_accelerator_impl<Handle> type;
+        typedef typename type::iterator iterator;
+        typedef typename type::buffer   buffer;
+        static inline Handle handle(iterator it) { return *it; }
+    };
+
+}; // namespace marked_point_process
+
+#endif // GRID_ACCELERATOR_HPP
@@ -0,0 +1,109 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+#ifndef INTERACTION_PIPELINE_HPP
+#define INTERACTION_PIPELINE_HPP
+
+#include <boost/mpl/bool.hpp>
+#include "rjmcmc/rjmcmc/energy/interaction_traits.hpp"
+#include "bounding_box.hpp"
+
+namespace marked_point_process {
+
+    // number of candidate pairs of an interaction_pipeline, and of those pruned by each stage,
+    // along with the unary energy evaluations of the configuration that owns the pipeline
+    struct interaction_statistics {
+        unsigned long candidates;
+        unsigned long bbox_pruned;     // disjoint bounding boxes
+        unsigned long interact_pruned; // rejected by the interact() test of the energy
+        unsigned long evaluated;       // exact evaluations of the energy
+        unsigned long unary;           // unary energy evaluations
+        interaction_statistics() : candidates(0), bbox_pruned(0), interact_pruned(0), evaluated(0), unary(0) {}
+    };
+
+    // Staged evaluation of a binary energy between candidate pairs, whatever the accelerator that reported them :
+    // disjoint bounding boxes (if the energy is bounded), then the interact() test of the energy, then the exact energy.
+    // The bounding boxes are computed by box() and cached by the configurations, they are left empty if the energy is not bounded.
+    // The stages are counted in the statistics given by the caller, so that concurrent evaluations do not share counters.
+    template<typename BinaryEnergy>
+    class interaction_pipeline {
+        typedef rjmcmc::interaction_traits<BinaryEnergy> traits;
+        typedef boost::mpl::bool_<traits::bounded::value> bounded;
+    public:
+        interaction_pipeline(const BinaryEnergy& e) : m_energy(e), m_non_negative(traits::non_negative(e)) {}
+
+        inline const BinaryEnergy& energy() const { return m_energy; }
+        // partial sums of binary energies are lower bounds of the complete sums
+        inline bool non_negative() const { return m_non_negative; }
+
+        template<typename T> inline bounding_box box(const T& t) const { return box(t,bounded()); }
+
+        // binary energy of t and u, given their boxes
+        template<typename T, typename U>
+        inline double operator()(const T& t, const bounding_box& bt, const U& u, const bounding_box& bu, interaction_statistics& s) const
+        {
+            ++s.candidates;
+            if(bounded::value && !bt.intersects(bu)) { ++s.bbox_pruned; return 0; }
+            return exact(t,u,s);
+        }
+
+        // binary energy of t and u, without their boxes
+        template<typename T, typename U>
+        inline double operator()(const T& t, const U& u, interaction_statistics& s) const
+        {
+            ++s.candidates;
+            return exact(t,u,s);
+        }
+
+    private:
+        template<typename T, typename U>
+        inline double exact(const T& t, const U& u, interaction_statistics& s) const
+        {
+            if(!rjmcmc::interact(m_energy,t,u)) { ++s.interact_pruned; return 0; }
+            ++s.evaluated;
+            return rjmcmc::apply_visitor(m_energy,t,u);
+        }
+
+        template<typename T> static inline bounding_box box(const T& t, boost::mpl::true_ ) { return get_bounding_box(t); }
+        template<typename T> static inline bounding_box box(const T&  , boost::mpl::false_) { return bounding_box(); }
+
+        BinaryEnergy m_energy;
+        bool m_non_negative;
+    };
+
+}; // namespace marked_point_process
+
+#endif // INTERACTION_PIPELINE_HPP
@@ -0,0 +1,116 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+#ifndef OBSERVED_ACCELERATOR_HPP
+#define OBSERVED_ACCELERATOR_HPP
+
+#include "configuration.hpp"
+
+namespace marked_point_process {
+
+    // Accelerator adaptor that notifies an observer of the insertion and removal of each object of the configuration,
+    // neighbour queries being forwarded to the adapted accelerator.
+    // An Observer provides insert(t) and remove(t), called with the object t while it is in the configuration, and clear().
+    // The configuration stores a copy of the observer : observers that update an external state (e.g. a birth map)
+    // should share it between copies. Configuration copies rebuild their accelerator (clear, then insert of each object),
+    // so that such an observer follows the configuration that was last copied or modified.
+    template<typename Observer, typename Accelerator=trivial_accelerator>
+    class observed_accelerator {
+    public:
+        observed_accelerator(const Observer& observer, const Accelerator& accelerator=Accelerator())
+            : m_observer(observer), m_accelerator(accelerator) {}
+
+        inline const Observer& observer() const { return m_observer; }
+        inline const Accelerator& accelerator() const { return m_accelerator; }
+
+    private:
+        Observer m_observer;
+        Accelerator m_accelerator;
+    };
+
+    namespace internal {
+
+        // observed_accelerator rebound to the handle type of the configuration
+        template<typename Observer, typename Accelerator, typename Handle>
+        class observed_accelerator_impl {
+            typedef accelerator_traits<Accelerator,Handle> traits;
+            typedef typename traits::type accelerator_type;
+        public:
+            typedef typename traits::iterator iterator;
+            typedef typename traits::buffer   buffer;
+
+            observed_accelerator_impl(const observed_accelerator<Observer,Accelerator>& a)
+                : m_observer(a.observer()), m_accelerator(a.accelerator()) {}
+
+            template<typename C, typename T> inline std::pair<iterator,iterator> operator()(const C &c, const T &t, buffer& b) const
+            {
+                return m_accelerator(c,t,b);
+            }
+            template<typename C> inline void insert(const C &c, Handle h)
+            {
+                m_accelerator.insert(c,h);
+                m_observer.insert(c.value(h));
+            }
+            template<typename C> inline void remove(const C &c, Handle h)
+            {
+                m_observer.remove(c.value(h));
+                m_accelerator.remove(c,h);
+            }
+            inline void clear()
+            {
+                m_observer.clear();
+                m_accelerator.clear();
+            }
+
+            static inline Handle handle(iterator it) { return traits::handle(it); }
+
+        private:
+            Observer m_observer;
+            accelerator_type m_accelerator;
+        };
+
+    }; // namespace internal
+
+    template<typename Observer, typename Accelerator, typename Handle> struct accelerator_traits<observed_accelerator<Observer,Accelerator>,Handle> {
+        typedef internal::observed_accelerator_impl<Observer,Accelerator,Handle> type;
+        typedef typename type::iterator iterator;
+        typedef typename type::buffer   buffer;
+        static inline Handle handle(iterator it) { return type::handle(it); }
+    };
+
+}; // namespace marked_point_process
+
+#endif // OBSERVED_ACCELERATOR_HPP
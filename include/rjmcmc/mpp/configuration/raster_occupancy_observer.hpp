@@ -0,0 +1,128 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+#ifndef RASTER_OCCUPANCY_OBSERVER_HPP
+#define RASTER_OCCUPANCY_OBSERVER_HPP
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <boost/shared_ptr.hpp>
+#include "bounding_box.hpp"
+
+namespace marked_point_process {
+
+    // Observer (see observed_accelerator) that adapts a birth map to the configuration : the weight of the cells of
+    // a dynamic_raster_variate that are overlapped by the bounding box of an object of the configuration is
+    // multiplied by factor (e.g. 0 suppresses the births where objects already exist).
+    // The first two dimensions of the variate span the extent, the weights of all the voxels of a cell are updated.
+    // Copies share the cell counts and the variate weights.
+    // The cell counts follow the configuration, but the birth map is only updated by apply(), which must be called
+    // between runs (e.g. during a burn-in) : the Green ratio of a birth or a death assumes that the birth map
+    // does not depend on the configuration during a run.
+    template<typename Variate>
+    class raster_occupancy_observer {
+    public:
+        raster_occupancy_observer(const Variate& variate, const bounding_box& extent, double factor=0.)
+            : m_state(new state(variate,extent,factor)) {}
+
+        template<typename T> inline void insert(const T& t) { add(t,+1); }
+        template<typename T> inline void remove(const T& t) { add(t,-1); }
+        void clear() { std::fill(m_state->m_count.begin(),m_state->m_count.end(),0); }
+
+        // updates the weights of the cells that became occupied or free since the last call
+        void apply()
+        {
+            state& s = *m_state;
+            for(std::size_t c=0; c<s.m_count.size(); ++c) {
+                bool occupied = s.m_count[c]>0;
+                if(occupied==bool(s.m_occupied[c])) continue;
+                s.m_occupied[c] = occupied;
+                set_weights(int(c),occupied);
+            }
+        }
+
+        inline int count(int i, int j) const { return m_state->m_count[i+m_state->m_nx*j]; }
+        inline const Variate& variate() const { return m_state->m_variate; }
+
+    private:
+        struct state {
+            Variate m_variate;
+            bounding_box m_extent;
+            double m_factor;
+            int m_nx, m_ny;
+            std::vector<int> m_count;       // number of objects overlapping each cell
+            std::vector<char> m_occupied;   // occupancy of each cell in the variate weights
+            std::vector<double> m_base;     // initial weight of each voxel
+            state(const Variate& v, const bounding_box& extent, double factor)
+                : m_variate(v), m_extent(extent), m_factor(factor), m_nx(v.size(0)), m_ny(v.size(1))
+                , m_count(m_nx*m_ny,0), m_occupied(m_nx*m_ny,0), m_base(v.voxels())
+            {
+                for(int i=0; i<v.voxels(); ++i) m_base[i] = v.weight(i);
+            }
+        };
+
+        inline int cell(double x, double x0, double x1, int n) const
+        {
+            double i = std::floor(n*(x-x0)/(x1-x0));
+            return (i<0) ? 0 : ((i>=n) ? n-1 : int(i));
+        }
+
+        void set_weights(int c, bool occupied)
+        {
+            state& s = *m_state;
+            for(int offset=c; offset<int(s.m_base.size()); offset+=s.m_nx*s.m_ny)
+                s.m_variate.weight(offset, occupied ? s.m_factor*s.m_base[offset] : s.m_base[offset]);
+        }
+
+        template<typename T> void add(const T& t, int delta)
+        {
+            state& s = *m_state;
+            bounding_box b = get_bounding_box(t);
+            if(!b.intersects(s.m_extent)) return;
+            int i0 = cell(b.xmin,s.m_extent.xmin,s.m_extent.xmax,s.m_nx), i1 = cell(b.xmax,s.m_extent.xmin,s.m_extent.xmax,s.m_nx);
+            int j0 = cell(b.ymin,s.m_extent.ymin,s.m_extent.ymax,s.m_ny), j1 = cell(b.ymax,s.m_extent.ymin,s.m_extent.ymax,s.m_ny);
+            for(int j=j0; j<=j1; ++j)
+                for(int i=i0; i<=i1; ++i)
+                    s.m_count[i+s.m_nx*j] += delta;
+        }
+
+        boost::shared_ptr<state> m_state;
+    };
+
+}; // namespace marked_point_process
+
+#endif // RASTER_OCCUPANCY_OBSERVER_HPP
@@ -0,0 +1,128 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+#ifndef RTREE_ACCELERATOR_HPP
+#define RTREE_ACCELERATOR_HPP
+
+#include <vector>
+#include <iterator>
+#include <boost/geometry.hpp>
+#include <boost/geometry/index/rtree.hpp>
+#include <boost/function_output_iterator.hpp>
+#include "configuration.hpp"
+#include "bounding_box.hpp"
+
+namespace marked_point_process {
+
+    // Dynamic R*-tree accelerator : the bounding boxes of the objects of the configuration are indexed in a boost::geometry R*-tree,
+    // which adapts to objects of very uneven sizes where a uniform grid degenerates.
+    // The neighbour candidates of an object are the indexed objects whose bounding box intersects its own bounding box,
+    // dilated by the margin. This is exact as long as objects farther apart than the margin do not interact.
+    class rtree_accelerator {
+    public:
+        rtree_accelerator(double margin=0) : m_margin(margin) {}
+        inline double margin() const { return m_margin; }
+    private:
+        double m_margin;
+    };
+
+    namespace internal {
+
+        // rtree_accelerator rebound to the handle type of the configuration
+        template<typename Handle>
+        class rtree_accelerator_impl {
+            typedef accelerator_key<Handle> key;
+            typedef typename key::type key_type;
+            typedef boost::geometry::model::point<double,2,boost::geometry::cs::cartesian> point_type;
+            typedef boost::geometry::model::box<point_type> box_type;
+            typedef std::pair<box_type,key_type> value_type;
+            typedef boost::geometry::index::rtree<value_type,boost::geometry::index::rstar<16> > rtree_type;
+
+            // decodes the query results directly into the buffer of the caller
+            template<typename C> struct decoder {
+                const C& m_c;
+                std::vector<Handle>& m_result;
+                decoder(const C& c, std::vector<Handle>& result) : m_c(c), m_result(result) {}
+                inline void operator()(const value_type& v) const { m_result.push_back(key::decode(m_c,v.second)); }
+            };
+
+        public:
+            typedef std::vector<Handle> buffer;
+            typedef typename buffer::const_iterator iterator;
+
+            rtree_accelerator_impl(const rtree_accelerator& r) : m_margin(r.margin()) {}
+
+            template<typename C, typename T> std::pair<iterator,iterator> operator()(const C &c, const T &t, buffer& result) const
+            {
+                result.clear();
+                m_rtree.query(boost::geometry::index::intersects(box(get_bounding_box(t).dilate(m_margin))),
+                              boost::make_function_output_iterator(decoder<C>(c,result)));
+                return std::make_pair(result.begin(),result.end());
+            }
+
+            template<typename C> inline void insert(const C &c, Handle h)
+            {
+                m_rtree.insert(value_type(box(get_bounding_box(c.value(h))),key::encode(c,h)));
+            }
+
+            template<typename C> inline void remove(const C &c, Handle h)
+            {
+                m_rtree.remove(value_type(box(get_bounding_box(c.value(h))),key::encode(c,h)));
+            }
+
+            inline void clear() { m_rtree.clear(); }
+
+        private:
+            static inline box_type box(const bounding_box& b) {
+                return box_type(point_type(b.xmin,b.ymin),point_type(b.xmax,b.ymax));
+            }
+
+            double m_margin;
+            rtree_type m_rtree;
+        };
+
+    }; // namespace internal
+
+    template<typename Handle> struct accelerator_traits<rtree_accelerator,Handle> {
+        typedef internal::rtree_accelerator_impl<Handle> type;
+        typedef typename type::iterator iterator;
+        typedef typename type::buffer   buffer;
+        static inline Handle handle(iterator it) { return *it; }
+    };
+
+}; // namespace marked_point_process
+
+#endif // RTREE_ACCELERATOR_HPP
@@ -37,7 +37,10 @@ knowledge of the CeCILL license and that you accept its terms.
 #ifndef VECTOR_CONFIGURATION_HPP
 #define VECTOR_CONFIGURATION_HPP
 
+#include <limits>
+#include <boost/tuple/tuple.hpp> // tie
 #include "configuration.hpp"
+#include "interaction_pipeline.hpp"
 #include "rjmcmc/util/variant.hpp"
 
 namespace marked_point_process {
@@ -46,20 +49,28 @@ namespace marked_point_process {
     class vector_configuration
     {
 	typedef	std::vector<T> container;
-	container	m_container;
-	UnaryEnergy	m_unary_energy;
-	BinaryEnergy	m_binary_energy;
-	Accelerator	m_accelerator;
     public:
         typedef typename container::const_iterator const_iterator;
         typedef typename container::iterator       iterator;
         typedef T					value_type;
 	typedef vector_configuration<T,UnaryEnergy, BinaryEnergy, Accelerator> self;
         typedef internal::modification<self>	        modification;
+    private:
+        typedef accelerator_traits<Accelerator,const_iterator> accelerator_traits_type;
+        typedef typename accelerator_traits_type::type      accelerator_type;
+        typedef typename accelerator_traits_type::iterator  accelerator_iterator;
+        typedef typename accelerator_traits_type::buffer    accelerator_buffer;
+
+	container	m_container;
+	UnaryEnergy	m_unary_energy;
+	interaction_pipeline<BinaryEnergy>	m_interactions; // no bounding boxes are cached, only the interact() stage is used
+	interaction_statistics	m_statistics;
+	accelerator_type	m_accelerator;
+    public:
 
 
         vector_configuration(UnaryEnergy unary_energy, BinaryEnergy binary_energy, Accelerator accelerator=Accelerator())
-            : m_unary_energy(unary_energy), m_binary_energy(binary_energy), m_accelerator(accelerator)
+            : m_unary_energy(unary_energy), m_interactions(binary_energy), m_accelerator(accelerator)
 	{}
 
 
@@ -70,19 +81,28 @@ namespace marked_point_process {
         inline iterator end  () { return m_container.end  (); }
         inline const_iterator begin() const { return m_container.begin(); }
         inline const_iterator end  () const { return m_container.end  (); }
+        inline const_iterator nth(size_t i) const { return m_container.begin()+i; }
         inline const value_type& value( const_iterator v ) const { return *v; }
 
 
         // container
-	inline void clear() { m_container.clear(); }
+	inline void clear() { m_accelerator.clear(); m_container.clear(); }
 
         template<typename U>
         void insert(const U&u) {
             m_container.push_back(u);
+            m_accelerator.insert(*this,const_iterator(m_container.end()-1));
 	}
+        // the last object is moved to the position of the removed one
         void remove( const_iterator  v ) {
-            std::swap(const_cast<value_type&>(*v),m_container.back());
+            const_iterator last = m_container.end()-1;
+            m_accelerator.remove(*this,v);
+            if(v!=last) {
+                m_accelerator.remove(*this,last);
+                std::swap(const_cast<value_type&>(*v),m_container.back());
+            }
             m_container.pop_back();
+            if(v!=last) m_accelerator.insert(*this,v);
 	}
 
         template<typename F> inline void for_each(F f)       { std::for_each(m_container.begin(),m_container.end(),f); }
@@ -104,60 +124,126 @@ namespace marked_point_process {
         double binary_energy() const
         {
             double e = 0.;
-            for (const_iterator i = m_container.begin(); i != m_container.end(); ++i)
-                for (const_iterator j = i+1; j != m_container.end(); ++j)
-                    e += rjmcmc::apply_visitor(m_binary_energy, *i, *j );
+            accelerator_buffer buffer;
+            for (const_iterator i = m_container.begin(); i != m_container.end(); ++i) {
+                accelerator_iterator it, end;
+                for (boost::tie(it,end)=m_accelerator(*this,*i,buffer); it != end; ++it) {
+                    const_iterator j = accelerator_traits_type::handle(it);
+                    if (i < j)
+                        e += rjmcmc::apply_visitor(m_interactions.energy(), *i, *j );
+                }
+            }
             return e;
         }
 
+        // number of binary energy evaluations by the non-const evaluators, audits excluded
+        inline unsigned long binary_evaluations() const { return m_statistics.evaluated; }
+        // number of unary energy evaluations by the non-const evaluators, audits excluded
+        inline unsigned long unary_evaluations() const { return m_statistics.unary; }
+        // candidate pairs pruned by each stage of the interaction pipeline
+        inline const interaction_statistics& pruning_statistics() const { return m_statistics; }
+
         // delta energy
+        // the const evaluators may be called concurrently, they count the energy evaluations in s or not at all.
+        // The non-const ones, called by the samplers, count them in pruning_statistics().
+        template <typename Modification> double delta_energy(const Modification &modif, interaction_statistics& s) const
+        {
+            return delta_birth(modif,s)+delta_death(modif,s);
+        }
         template <typename Modification> double delta_energy(const Modification &modif) const
         {
-            return delta_birth(modif)+delta_death(modif);
+            interaction_statistics s;
+            return delta_energy(modif,s);
+        }
+        template <typename Modification> double delta_energy(const Modification &modif)
+        {
+            return delta_energy(modif,m_statistics);
         }
 
-        template <typename Modification> double delta_birth(const Modification &modif) const
+        // delta_energy, or a lower bound of it greater than max_delta as soon as it is known to exceed max_delta.
+        // The evaluation stops early only if the binary energy is non-negative.
+        template <typename Modification> double delta_energy(const Modification &modif, double max_delta, interaction_statistics& s) const
+        {
+            if(!m_interactions.non_negative()) return delta_energy(modif,s);
+            return delta_birth(modif,s,delta_death(modif,s),max_delta);
+        }
+        template <typename Modification> double delta_energy(const Modification &modif, double max_delta) const
+        {
+            interaction_statistics s;
+            return delta_energy(modif,max_delta,s);
+        }
+        template <typename Modification> double delta_energy(const Modification &modif, double max_delta)
+        {
+            return delta_energy(modif,max_delta,m_statistics);
+        }
+
+        // returns delta plus the energy of the births, the binary energies are evaluated last
+        // and their evaluation stops as soon as the sum exceeds max_delta
+        template <typename Modification> double delta_birth(const Modification &modif, interaction_statistics& s, double delta=0,
+                                                            double max_delta=std::numeric_limits<double>::infinity()) const
         {
-            double delta = 0;
             typedef typename Modification::birth_type::const_iterator bci;
             typedef typename Modification::death_type::const_iterator dci;
             bci bbeg = modif.birth().begin();
             bci bend = modif.birth().end();
             dci dbeg = modif.death().begin();
             dci dend = modif.death().end();
-            for(bci it=bbeg; it!=bend; ++it) {
+            for(bci it=bbeg; it!=bend; ++it, ++s.unary)
                 delta += rjmcmc::apply_visitor(m_unary_energy,*it);
-                for (const_iterator it2=m_container.begin(); it2 != m_container.end(); ++it2)
-                    if (std::find(dbeg,dend,it2)==dend)
-                        delta += rjmcmc::apply_visitor(m_binary_energy, *it, value(it2) );
-                for (bci it2=it+1; it2 != bend; ++it2)
-                    delta += rjmcmc::apply_visitor(m_binary_energy, *it, *it2);
+            accelerator_buffer buffer;
+            for(bci it=bbeg; it!=bend; ++it) {
+                accelerator_iterator it2, end2;
+                for (boost::tie(it2,end2)=m_accelerator(*this,*it,buffer); it2 != end2; ++it2) {
+                    const_iterator v = accelerator_traits_type::handle(it2);
+                    if (std::find(dbeg,dend,v)==dend) {
+                        delta += m_interactions(*it, value(v), s);
+                        if (delta > max_delta) return delta;
+                    }
+                }
+                for (bci it2=it+1; it2 != bend; ++it2) {
+                    delta += m_interactions(*it, *it2, s);
+                    if (delta > max_delta) return delta;
+                }
             }
             return delta;
         }
 
-        template <typename Modification> double delta_death(const Modification &modif) const
+        template <typename Modification> double delta_death(const Modification &modif, interaction_statistics& s) const
         {
             double delta = 0;
             typedef typename Modification::death_type::const_iterator dci;
             dci dbeg = modif.death().begin();
             dci dend = modif.death().end();
-            for(dci it=dbeg; it!=dend; ++it) {
+            accelerator_buffer buffer;
+            for(dci it=dbeg; it!=dend; ++it, ++s.unary) {
                 delta -= rjmcmc::apply_visitor(m_unary_energy, value(*it));
-                for (const_iterator it2=m_container.begin(); it2 != m_container.end(); ++it2)
-                    if(std::find(it,dend,it2)==dend)
-                        delta -= rjmcmc::apply_visitor(m_binary_energy, value(*it), *it2 );
+                accelerator_iterator it2, end2;
+                for (boost::tie(it2,end2)=m_accelerator(*this,value(*it),buffer); it2 != end2; ++it2) {
+                    const_iterator v = accelerator_traits_type::handle(it2);
+                    if(std::find(it,dend,v)==dend)
+                        delta -= m_interactions(value(*it), value(v), s);
+                }
             }
             return delta;
         }
 
         // audit energy
 	inline double audit_unary_energy () const { return unary_energy();}
-	inline double audit_binary_energy() const { return binary_energy();}
+	double audit_binary_energy() const
+        {
+            double e = 0.;
+            for (const_iterator i = m_container.begin(); i != m_container.end(); ++i)
+                for (const_iterator j = i+1; j != m_container.end(); ++j)
+                    e += rjmcmc::apply_visitor(m_interactions.energy(), *i, *j );
+            return e;
+        }
 	inline unsigned int audit_structure() const { return 0; }
     };
 
 
+    template<typename T, typename U, typename B, typename A>
+    struct is_random_access_configuration< vector_configuration<T,U,B,A> > : boost::true_type {};
+
 }; // namespace marked_point_process
 
 #endif // VECTOR_CONFIGURATION_HPP
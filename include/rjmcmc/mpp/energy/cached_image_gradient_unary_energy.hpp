@@ -0,0 +1,79 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+#ifndef CACHED_IMAGE_GRADIENT_UNARY_ENERGY_HPP
+#define CACHED_IMAGE_GRADIENT_UNARY_ENERGY_HPP
+
+#include "rjmcmc/geometry/integrated_flux/all.hpp"
+#include "rjmcmc/geometry/integrated_flux/segment_flux_cache.hpp"
+#include "rjmcmc/rjmcmc/energy/energy.hpp"
+
+// Same energy as image_gradient_unary_energy, up to rounding errors.
+// The flux of rectangle edges is cached, so that the energy of a rectangle after an edge move
+// costs one edge and two pieces of edges traversals instead of four edge traversals,
+// and the energy of an accepted rectangle is not computed again when it is inserted.
+// Copies start with an empty cache : concurrent optimizers must each use their own copy.
+template<typename Image, typename Value = double>
+class cached_image_gradient_unary_energy : public rjmcmc::energy<Value>
+{
+public:
+    typedef Value result_type;
+    template<typename T>
+    inline result_type operator()(const T &t) const
+    {
+        return integrated_flux(m_image,t);
+    }
+
+    template<typename K>
+    inline result_type operator()(const geometry::Rectangle_2<K> &r) const
+    {
+        return m_cache(m_image,r.segment(0))
+             + m_cache(m_image,r.segment(1))
+             + m_cache(m_image,r.segment(2))
+             + m_cache(m_image,r.segment(3));
+    }
+
+    cached_image_gradient_unary_energy(const Image& image, std::size_t capacity = (1<<16))
+        : m_image(image), m_cache(capacity) {}
+
+    inline const segment_flux_cache& cache() const { return m_cache; }
+
+private:
+    Image m_image;
+    mutable segment_flux_cache m_cache;
+};
+
+#endif /*CACHED_IMAGE_GRADIENT_UNARY_ENERGY_HPP*/
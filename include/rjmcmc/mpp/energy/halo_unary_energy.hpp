@@ -0,0 +1,103 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+#ifndef HALO_UNARY_ENERGY_HPP
+#define HALO_UNARY_ENERGY_HPP
+
+#include <vector>
+#include <limits>
+#include <boost/shared_ptr.hpp>
+#include "rjmcmc/rjmcmc/energy/energy.hpp"
+#include "rjmcmc/mpp/configuration/bounding_box.hpp"
+
+namespace marked_point_process {
+
+    namespace internal {
+        // binary energy with a bound first argument, to visit a (possibly variant) second argument
+        template<typename BinaryEnergy, typename T>
+        struct bind_first_energy {
+            typedef double result_type;
+            const BinaryEnergy& m_binary;
+            const T& m_t;
+            bind_first_energy(const BinaryEnergy& b, const T& t) : m_binary(b), m_t(t) {}
+            template<typename U> inline result_type operator()(const U &u) const { return m_binary(m_t,u); }
+        };
+    }; // namespace internal
+
+    // Unary energy of the objects of a sub-configuration restricted to a cell, the other objects being frozen.
+    // It adds to the unary energy the binary energies with the frozen objects of the halo,
+    // so that energy differences within the cell are the same as in the whole configuration.
+    // Objects whose bounding box center is outside the cell, or whose bounding box exceeds the extent box, are forbidden (infinite energy).
+    template<typename UnaryEnergy, typename BinaryEnergy, typename Value>
+    class halo_unary_energy : public rjmcmc::energy<double>
+    {
+    public:
+        typedef double result_type;
+        typedef std::vector< std::pair<bounding_box,Value> > halo_type;
+
+        // the cell is half-open : [xmin,xmax)x[ymin,ymax). Halo objects farther than range from an object do not interact with it.
+        halo_unary_energy(const UnaryEnergy& unary, const BinaryEnergy& binary,
+                          const bounding_box& cell, const bounding_box& extent, double range,
+                          const boost::shared_ptr<const halo_type>& halo)
+            : m_unary(unary), m_binary(binary), m_cell(cell), m_extent(extent), m_range(range), m_halo(halo)
+        {}
+
+        template<typename T>
+        inline result_type operator()(const T &t) const
+        {
+            bounding_box b = get_bounding_box(t);
+            double x = 0.5*(b.xmin+b.xmax), y = 0.5*(b.ymin+b.ymax);
+            if(x<m_cell.xmin || x>=m_cell.xmax || y<m_cell.ymin || y>=m_cell.ymax || !m_extent.contains(b))
+                return std::numeric_limits<double>::infinity();
+            double e = rjmcmc::apply_visitor(m_unary,t);
+            b = b.dilate(m_range);
+            internal::bind_first_energy<BinaryEnergy,T> binary(m_binary,t);
+            for(typename halo_type::const_iterator it=m_halo->begin(); it!=m_halo->end(); ++it)
+                if(b.intersects(it->first)) e += rjmcmc::apply_visitor(binary,it->second);
+            return e;
+        }
+
+    private:
+        UnaryEnergy  m_unary;
+        BinaryEnergy m_binary;
+        bounding_box m_cell, m_extent;
+        double m_range;
+        boost::shared_ptr<const halo_type> m_halo;
+    };
+
+}; // namespace marked_point_process
+
+#endif // HALO_UNARY_ENERGY_HPP
@@ -38,6 +38,7 @@ knowledge of the CeCILL license and that you accept its terms.
 #define INTERSECTION_AREA_BINARY_ENERGY_HPP
 
 #include "rjmcmc/geometry/intersection/all.hpp"
+#include "rjmcmc/rjmcmc/energy/interaction_traits.hpp"
 #include <cmath>
 
 template<typename Value = double>
@@ -60,5 +61,18 @@ public:
 
 };
 
+namespace rjmcmc {
+
+    // the intersection area is non-negative, and zero for objects with disjoint bounding boxes
+    template<typename Value>
+    struct interaction_traits< intersection_area_binary_energy<Value> > {
+        typedef boost::true_type bounded;
+        template<typename T, typename U>
+        static inline bool interact(const intersection_area_binary_energy<Value>& e, const T& t, const U& u) { return e.interact(t,u); }
+        static inline bool non_negative(const intersection_area_binary_energy<Value>&) { return true; }
+    };
+
+}; // namespace rjmcmc
+
 #endif /*INTERSECTION_AREA_BINARY_ENERGY_HPP*/
 
@@ -40,6 +40,7 @@ knowledge of the CeCILL license and that you accept its terms.
 #include <boost/random/uniform_smallint.hpp>
 
 #include "rjmcmc/geometry/coordinates/coordinates.hpp"
+#include "rjmcmc/mpp/configuration/configuration.hpp" // nth
 
 namespace marked_point_process {
     
@@ -68,8 +69,7 @@ namespace marked_point_process {
                 d[i]=die(e);
                 for(unsigned int j=0;j<i;++j) if(d[j]<=d[i]) ++d[i]; // skip already selected indices
 
-                typename Configuration::const_iterator it = c.begin();
-                std::advance(it, d[i]);
+                typename Configuration::const_iterator it = nth(c, d[i]);
                 m.death().push_back(it);
                 const T& t = c.value(it);
                 iterator coord_it  = coordinates_begin(t,e);
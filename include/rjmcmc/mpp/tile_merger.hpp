@@ -0,0 +1,141 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+#ifndef MPP_TILE_MERGER_HPP
+#define MPP_TILE_MERGER_HPP
+
+#include <vector>
+#include <iterator>
+#include <algorithm>
+#include <boost/geometry.hpp>
+#include <boost/geometry/index/rtree.hpp>
+#include "rjmcmc/mpp/configuration/bounding_box.hpp"
+
+namespace marked_point_process {
+
+    // Merges the configurations of overlapping tiles processed by rows of increasing y, and streams the result.
+    // Each tile contributes the objects whose center lies in its core (the tile without its overlap band) : add(t,energy,tile).
+    // Objects of distinct tiles that intersect are duplicates : among them, the objects of lowest energy are kept (greedily).
+    // Objects are assumed to extend at most 'band' beyond the core of their tile, so that once a row is flushed,
+    // only its kept objects that reach within 'band' of the next row are held back. Memory thus grows with a row of tiles,
+    // not with the whole domain. The output is a functor called once with each object kept.
+    template<typename T>
+    class tile_merger {
+    public:
+        explicit tile_merger(double band) : m_band(band), m_written(0), m_dropped(0) {}
+
+        inline void add(const T& t, double energy, int tile) { m_row.push_back(candidate(t,energy,tile)); }
+
+        // resolves the duplicates of the current row and of the objects held back from the previous one,
+        // then outputs the kept objects that cannot intersect the objects of the rows below y.
+        template<typename Output> void flush_row(double y, Output& out)
+        {
+            resolve();
+            m_pending.clear();
+            for(typename std::vector<candidate>::const_iterator it=m_row.begin(); it!=m_row.end(); ++it)
+            {
+                if(it->m_bbox.ymax>y-m_band) m_pending.push_back(*it);
+                else { out(it->m_object); ++m_written; }
+            }
+            m_row.clear();
+        }
+
+        // outputs all the remaining objects
+        template<typename Output> void flush(Output& out)
+        {
+            resolve();
+            for(typename std::vector<candidate>::const_iterator it=m_row.begin(); it!=m_row.end(); ++it)
+            { out(it->m_object); ++m_written; }
+            m_row.clear();
+            m_pending.clear();
+        }
+
+        inline std::size_t written() const { return m_written; }
+        inline std::size_t dropped() const { return m_dropped; }
+        inline std::size_t held() const { return m_pending.size()+m_row.size(); }
+
+    private:
+        typedef boost::geometry::model::point<double,2,boost::geometry::cs::cartesian> point_type;
+        typedef boost::geometry::model::box<point_type> box_type;
+        typedef std::pair<box_type,std::size_t> value_type;
+        typedef boost::geometry::index::rtree<value_type,boost::geometry::index::rstar<16> > rtree_type;
+
+        struct candidate {
+            T m_object;
+            double m_energy;
+            int m_tile;
+            bounding_box m_bbox;
+            candidate(const T& t, double e, int tile) : m_object(t), m_energy(e), m_tile(tile), m_bbox(get_bounding_box(t)) {}
+            bool operator<(const candidate& c) const { return m_energy<c.m_energy; }
+        };
+
+        static inline box_type box(const bounding_box& b) {
+            return box_type(point_type(b.xmin,b.ymin),point_type(b.xmax,b.ymax));
+        }
+
+        // keeps in m_row the candidates of m_row and m_pending that do not intersect a candidate of lower energy of another tile
+        void resolve()
+        {
+            m_row.insert(m_row.end(),m_pending.begin(),m_pending.end());
+            std::stable_sort(m_row.begin(),m_row.end());
+            std::vector<candidate> kept;
+            rtree_type rtree;
+            std::vector<value_type> query;
+            for(typename std::vector<candidate>::const_iterator it=m_row.begin(); it!=m_row.end(); ++it)
+            {
+                query.clear();
+                rtree.query(boost::geometry::index::intersects(box(it->m_bbox)), std::back_inserter(query));
+                bool duplicate = false;
+                for(typename std::vector<value_type>::const_iterator q=query.begin(); !duplicate && q!=query.end(); ++q)
+                {
+                    const candidate& k = kept[q->second];
+                    duplicate = (k.m_tile!=it->m_tile) && do_intersect(k.m_object,it->m_object);
+                }
+                if(duplicate) { ++m_dropped; continue; }
+                rtree.insert(value_type(box(it->m_bbox),kept.size()));
+                kept.push_back(*it);
+            }
+            m_row.swap(kept);
+        }
+
+        double m_band;
+        std::vector<candidate> m_row, m_pending;
+        std::size_t m_written, m_dropped;
+    };
+
+}; // namespace marked_point_process
+
+#endif // MPP_TILE_MERGER_HPP
@@ -38,6 +38,7 @@ knowledge of the CeCILL license and that you accept its terms.
 #define METROPOLIS_ACCEPTANCE_HPP
 
 #include <cmath>
+#include <limits>
 
 namespace rjmcmc
 {
@@ -56,6 +57,25 @@ namespace rjmcmc
         }
     };
 
+    /**
+     * \ingroup GroupAcceptance
+     *
+     * <i>Metropolis</i> acceptance rule, with the uniform variate \f$u\f$ drawn before the evaluation of \f$\Delta E\f$.
+     * The new state is accepted if \f$\Delta E < -T\log(u/green\_ratio)\f$, so that the configuration may stop
+     * the evaluation of \f$\Delta E\f$ as soon as it exceeds this bound.
+     */
+    class early_exit_metropolis_acceptance : public metropolis_acceptance
+    {
+    public:
+        typedef void early_exit; // tells the sampler to draw the uniform variate first
+
+        inline double max_delta(double u, double temperature, double green_ratio) const
+        {
+            if(u<=0) return std::numeric_limits<double>::infinity();
+            return -temperature*log(u/green_ratio);
+        }
+    };
+
 } // namespace rjmcmc
 
 #endif // METROPOLIS_ACCEPTANCE_HPP
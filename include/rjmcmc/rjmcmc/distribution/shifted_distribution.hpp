@@ -0,0 +1,75 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+#ifndef __SHIFTED_DISTRIBUTION_HPP__
+#define __SHIFTED_DISTRIBUTION_HPP__
+
+namespace rjmcmc {
+
+    // distribution of the count of a sub-configuration, when 'offset' objects are held fixed outside of it :
+    // the pdf and pdf ratios are those of the total count n+offset.
+    // Sampling is not supported, this is only meant for the reference process of restricted samplers.
+    template<typename Distribution>
+    class shifted_distribution {
+    public:
+        typedef typename Distribution::real_type real_type;
+        typedef typename Distribution::int_type  int_type;
+
+        shifted_distribution(const Distribution& d, int_type offset)
+            : m_distribution(d)
+            , m_offset(offset)
+        {}
+
+        real_type pdf_ratio(int_type n0, int_type n1) const
+        {
+            return m_distribution.pdf_ratio(n0+m_offset,n1+m_offset);
+        }
+
+        real_type pdf(int_type n) const
+        {
+            return m_distribution.pdf(n+m_offset);
+        }
+
+        inline int_type offset() const { return m_offset; }
+
+    private:
+        Distribution m_distribution;
+        int_type m_offset;
+    };
+
+}; // namespace rjmcmc
+
+#endif // __SHIFTED_DISTRIBUTION_HPP__
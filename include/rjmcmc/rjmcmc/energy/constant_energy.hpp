@@ -47,6 +47,7 @@ public:
     template<typename T> result_type operator()(const T &) const { return m_energy; }
     template<typename T,typename U> result_type operator()(const T &, const U &) const { return m_energy; }
     constant_energy(Value energy) { m_energy = energy; }
+    inline Value value() const { return m_energy; }
 
 private:
     Value m_energy;
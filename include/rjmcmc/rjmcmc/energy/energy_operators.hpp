@@ -49,6 +49,7 @@ public:
     template<typename T,typename U> result_type operator()(const T &t, const U &u) const { return m_operator(m_energy(t,u)); }
     unary_operator_energy(const Energy& energy, Operator op=Operator())
         : m_energy(energy), m_operator(op) {}
+    inline const Energy& energy() const { return m_energy; }
 
 private:
     Energy m_energy;
@@ -66,6 +67,8 @@ public:
     template<typename T,typename U> result_type operator()(const T &t, const U &u) const { return m_operator(m_energy0(t,u),m_energy1(t,u)); }
     binary_operator_energy(const Energy0& energy0, const Energy1& energy1, Operator op=Operator())
         : m_energy0(energy0), m_energy1(energy1), m_operator(op) {}
+    inline const Energy0& energy0() const { return m_energy0; }
+    inline const Energy1& energy1() const { return m_energy1; }
 
 private:
     Energy0 m_energy0;
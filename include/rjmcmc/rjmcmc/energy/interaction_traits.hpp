@@ -0,0 +1,146 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+#ifndef INTERACTION_TRAITS_HPP
+#define INTERACTION_TRAITS_HPP
+
+#include <boost/type_traits/integral_constant.hpp>
+#include <boost/mpl/and.hpp>
+#include <boost/mpl/or.hpp>
+#include "rjmcmc/util/variant.hpp" // apply_visitor
+#include "energy_operators.hpp"
+
+namespace rjmcmc {
+
+    // Cheap tests of a binary energy, used to skip the evaluation of pairs whose energy is known to be zero :
+    // - bounded::value : the energy is zero for objects with disjoint bounding boxes,
+    // - interact(e,t,u) : false only if e(t,u) is zero,
+    // - non_negative(e) : e(t,u)>=0 for all t and u, so that partial sums of binary energies are lower bounds.
+    // The default is conservative and never skips an evaluation.
+    template<typename Energy>
+    struct interaction_traits {
+        typedef boost::false_type bounded;
+        template<typename T, typename U>
+        static inline bool interact(const Energy&, const T&, const U&) { return true; }
+        static inline bool non_negative(const Energy&) { return false; }
+    };
+
+    // interaction test on objects or variants
+    template<typename Energy>
+    struct interaction_functor {
+        typedef bool result_type;
+        const Energy& m_energy;
+        interaction_functor(const Energy& e) : m_energy(e) {}
+        template<typename T, typename U>
+        inline bool operator()(const T& t, const U& u) const { return interaction_traits<Energy>::interact(m_energy,t,u); }
+    };
+
+    template<typename Energy, typename T, typename U>
+    inline bool interact(const Energy& e, const T& t, const U& u)
+    {
+        return rjmcmc::apply_visitor(interaction_functor<Energy>(e),t,u);
+    }
+
+    template<typename Value>
+    struct interaction_traits< constant_energy<Value> > {
+        typedef boost::false_type bounded;
+        template<typename T, typename U>
+        static inline bool interact(const constant_energy<Value>& e, const T&, const U&) { return e.value()!=0; }
+        static inline bool non_negative(const constant_energy<Value>& e) { return e.value()>=0; }
+    };
+
+    // a product is zero as soon as one of its factors is zero
+    template<typename E0, typename E1>
+    struct interaction_traits< multiplies_energy<E0,E1> > {
+        typedef typename boost::mpl::or_<typename interaction_traits<E0>::bounded,typename interaction_traits<E1>::bounded>::type bounded;
+        template<typename T, typename U>
+        static inline bool interact(const multiplies_energy<E0,E1>& e, const T& t, const U& u) {
+            return interaction_traits<E0>::interact(e.energy0(),t,u) && interaction_traits<E1>::interact(e.energy1(),t,u);
+        }
+        static inline bool non_negative(const multiplies_energy<E0,E1>& e) {
+            return interaction_traits<E0>::non_negative(e.energy0()) && interaction_traits<E1>::non_negative(e.energy1());
+        }
+    };
+
+    // a quotient is zero when its numerator is
+    template<typename E0, typename E1>
+    struct interaction_traits< divides_energy<E0,E1> > {
+        typedef typename interaction_traits<E0>::bounded bounded;
+        template<typename T, typename U>
+        static inline bool interact(const divides_energy<E0,E1>& e, const T& t, const U& u) {
+            return interaction_traits<E0>::interact(e.energy0(),t,u);
+        }
+        static inline bool non_negative(const divides_energy<E0,E1>& e) {
+            return interaction_traits<E0>::non_negative(e.energy0()) && interaction_traits<E1>::non_negative(e.energy1());
+        }
+    };
+
+    // a sum or a difference is zero when both of its terms are
+    template<typename E0, typename E1>
+    struct interaction_traits< plus_energy<E0,E1> > {
+        typedef typename boost::mpl::and_<typename interaction_traits<E0>::bounded,typename interaction_traits<E1>::bounded>::type bounded;
+        template<typename T, typename U>
+        static inline bool interact(const plus_energy<E0,E1>& e, const T& t, const U& u) {
+            return interaction_traits<E0>::interact(e.energy0(),t,u) || interaction_traits<E1>::interact(e.energy1(),t,u);
+        }
+        static inline bool non_negative(const plus_energy<E0,E1>& e) {
+            return interaction_traits<E0>::non_negative(e.energy0()) && interaction_traits<E1>::non_negative(e.energy1());
+        }
+    };
+
+    template<typename E0, typename E1>
+    struct interaction_traits< minus_energy<E0,E1> > {
+        typedef typename boost::mpl::and_<typename interaction_traits<E0>::bounded,typename interaction_traits<E1>::bounded>::type bounded;
+        template<typename T, typename U>
+        static inline bool interact(const minus_energy<E0,E1>& e, const T& t, const U& u) {
+            return interaction_traits<E0>::interact(e.energy0(),t,u) || interaction_traits<E1>::interact(e.energy1(),t,u);
+        }
+        static inline bool non_negative(const minus_energy<E0,E1>&) { return false; }
+    };
+
+    template<typename E>
+    struct interaction_traits< negate_energy<E> > {
+        typedef typename interaction_traits<E>::bounded bounded;
+        template<typename T, typename U>
+        static inline bool interact(const negate_energy<E>& e, const T& t, const U& u) {
+            return interaction_traits<E>::interact(e.energy(),t,u);
+        }
+        static inline bool non_negative(const negate_energy<E>&) { return false; }
+    };
+
+}; // namespace rjmcmc
+
+#endif // INTERACTION_TRAITS_HPP
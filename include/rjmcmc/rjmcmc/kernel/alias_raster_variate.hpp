@@ -0,0 +1,133 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+#ifndef RJMCMC_ALIAS_RASTER_VARIATE_HPP
+#define RJMCMC_ALIAS_RASTER_VARIATE_HPP
+
+#include <boost/random/uniform_real.hpp>
+#include <boost/cstdint.hpp>
+#include <vector>
+
+namespace rjmcmc {
+
+
+    // same variate as raster_variate, where the voxel is sampled in O(1) using the alias method (Walker/Vose)
+    // instead of a binary search in the cumulative distribution.
+    // the tables hold a float threshold, a uint32 alias and the float pdf of each voxel (12 bytes per voxel).
+    // the returned pdf is the one of the voxel, stored in float : the sampling and pdf() values agree exactly,
+    // and the actual voxel probabilities differ from them by float rounding only.
+
+    template<int N>
+    class alias_raster_variate
+    {
+        typedef boost::uniform_real<> rand_type;
+        mutable rand_type m_rand;
+
+    public:
+        typedef double value_type;
+        enum { dimension = N };
+        template<typename Engine, typename OutputIterator>
+        inline double operator()(Engine& e, OutputIterator it) const {
+            double u = m_rand(e)*m_totsize;
+            int offset = int(u);
+            if(offset>=m_totsize) offset = m_totsize-1;
+            if(u-offset>=m_prob[offset]) offset = m_alias[offset];
+            double pdf = m_pdf[offset];
+            for(int i=0; i<N; ++i)
+            {
+                int ix = offset % m_size[i];
+                *it++ = (ix+m_rand(e))/m_size[i];
+                offset /= m_size[i];
+            }
+            return pdf;
+        }
+        template<typename InputIterator>
+        inline double pdf(InputIterator it) const {
+            int offset = 0;
+            int stride = 1;
+            for(int i=0; i<N; ++i)
+            {
+                double x = *it++;
+                if(x<0. || x>=1.) return 0.;
+                int ix = int(x*m_size[i]);
+                offset += stride*ix;
+                stride *= m_size[i];
+            }
+            return m_pdf[offset];
+        }
+        template<typename T>
+        alias_raster_variate(T* pdf, int *size) {
+            m_size.resize(N);
+            m_totsize = 1;
+            for(int i=0; i<N; ++i) { m_totsize *= size[i]; m_size[i] = size[i]; }
+            double sum = 0;
+            for(int i=0; i<m_totsize; ++i) sum += pdf[i]; // assert(pdf[i]>=0)
+            m_prob.resize(m_totsize);
+            m_alias.resize(m_totsize);
+            m_pdf.resize(m_totsize);
+            // Vose's algorithm : voxels with a scaled probability below 1 are completed by a voxel above 1
+            std::vector<double> p(m_totsize);
+            std::vector<boost::uint32_t> small, large;
+            for(int i=0; i<m_totsize; ++i) {
+                p[i] = (sum>0) ? pdf[i]*(m_totsize/sum) : 1.;
+                m_pdf[i] = float((sum>0) ? p[i] : 0.);
+                m_alias[i] = i;
+                (p[i]<1. ? small : large).push_back(i);
+            }
+            while(!small.empty() && !large.empty()) {
+                boost::uint32_t s = small.back(); small.pop_back();
+                boost::uint32_t l = large.back();
+                m_prob [s] = float(p[s]);
+                m_alias[s] = l;
+                p[l] -= 1.-p[s];
+                if(p[l]<1.) { large.pop_back(); small.push_back(l); }
+            }
+            // remaining voxels have a scaled probability of 1 up to rounding errors
+            for(std::size_t i=0; i<small.size(); ++i) m_prob[small[i]] = 1.f;
+            for(std::size_t i=0; i<large.size(); ++i) m_prob[large[i]] = 1.f;
+        }
+    private:
+        std::vector<float> m_prob;
+        std::vector<boost::uint32_t> m_alias;
+        std::vector<float> m_pdf;
+        std::vector<int> m_size;
+        int m_totsize;
+    };
+
+
+}; // namespace rjmcmc
+
+#endif // RJMCMC_ALIAS_RASTER_VARIATE_HPP
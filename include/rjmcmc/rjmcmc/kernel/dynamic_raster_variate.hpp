@@ -0,0 +1,135 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+#ifndef RJMCMC_DYNAMIC_RASTER_VARIATE_HPP
+#define RJMCMC_DYNAMIC_RASTER_VARIATE_HPP
+
+#include <boost/random/uniform_real.hpp>
+#include <boost/shared_ptr.hpp>
+#include <vector>
+
+namespace rjmcmc {
+
+
+    // same variate as raster_variate, where the unnormalized pdf of each voxel may be updated during sampling in O(log n).
+    // the voxel weights are the leaves of a binary tree of partial sums, whose nodes are recomputed from their children
+    // on each update, so that no rounding error accumulates : the sampled pdf and pdf() are exact for the current weights.
+    // copies share their weights, so that the variate of a kernel may be updated through a copy (see raster_occupancy_observer).
+
+    template<int N>
+    class dynamic_raster_variate
+    {
+        typedef boost::uniform_real<> rand_type;
+        mutable rand_type m_rand;
+
+    public:
+        typedef double value_type;
+        enum { dimension = N };
+        template<typename Engine, typename OutputIterator>
+        inline double operator()(Engine& e, OutputIterator it) const {
+            const std::vector<double>& tree = *m_tree;
+            double x = m_rand(e)*tree[1];
+            int node = 1;
+            while(node<m_leaves) {
+                node <<= 1;
+                // zero weight subtrees are never selected, even by rounding
+                if(x>=tree[node] && tree[node+1]>0) { x -= tree[node]; ++node; }
+            }
+            int offset = node-m_leaves;
+            double pdf = voxel_pdf(offset);
+            for(int i=0; i<N; ++i)
+            {
+                int ix = offset % m_size[i];
+                *it++ = (ix+m_rand(e))/m_size[i];
+                offset /= m_size[i];
+            }
+            return pdf;
+        }
+        template<typename InputIterator>
+        inline double pdf(InputIterator it) const {
+            int offset = 0;
+            int stride = 1;
+            for(int i=0; i<N; ++i)
+            {
+                double x = *it++;
+                if(x<0. || x>=1.) return 0.;
+                int ix = int(x*m_size[i]);
+                offset += stride*ix;
+                stride *= m_size[i];
+            }
+            return voxel_pdf(offset);
+        }
+        template<typename T>
+        dynamic_raster_variate(T* pdf, int *size) {
+            m_size.resize(N);
+            m_totsize = 1;
+            for(int i=0; i<N; ++i) { m_totsize *= size[i]; m_size[i] = size[i]; }
+            m_leaves = 1;
+            while(m_leaves<m_totsize) m_leaves <<= 1;
+            m_tree.reset(new std::vector<double>(2*m_leaves,0.));
+            std::vector<double>& tree = *m_tree;
+            for(int i=0; i<m_totsize; ++i) tree[m_leaves+i] = pdf[i]; // assert(pdf[i]>=0)
+            for(int node=m_leaves-1; node>0; --node) tree[node] = tree[2*node]+tree[2*node+1];
+        }
+
+        // voxels are indexed by their offset, the first dimension varying the fastest
+        inline int size(int i) const { return m_size[i]; }
+        inline int voxels() const { return m_totsize; }
+        inline double weight(int offset) const { return (*m_tree)[m_leaves+offset]; }
+        inline double total_weight() const { return (*m_tree)[1]; }
+        void weight(int offset, double w) // assert(w>=0)
+        {
+            std::vector<double>& tree = *m_tree;
+            int node = m_leaves+offset;
+            tree[node] = w;
+            for(node>>=1; node>0; node>>=1) tree[node] = tree[2*node]+tree[2*node+1];
+        }
+
+    private:
+        inline double voxel_pdf(int offset) const {
+            const std::vector<double>& tree = *m_tree;
+            return tree[m_leaves+offset]*m_totsize/tree[1];
+        }
+
+        boost::shared_ptr<std::vector<double> > m_tree; // tree[1] is the root, tree[m_leaves+offset] the voxel weights
+        std::vector<int> m_size;
+        int m_totsize, m_leaves;
+    };
+
+
+}; // namespace rjmcmc
+
+#endif // RJMCMC_DYNAMIC_RASTER_VARIATE_HPP
@@ -0,0 +1,138 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+#ifndef RJMCMC_HIERARCHICAL_RASTER_VARIATE_HPP
+#define RJMCMC_HIERARCHICAL_RASTER_VARIATE_HPP
+
+#include <boost/random/uniform_real.hpp>
+#include <vector>
+#include <algorithm>
+#include <limits>
+
+namespace rjmcmc {
+
+
+    // same variate as raster_variate, for very large rasters : the cumulative distribution is split in two levels,
+    // a double cdf over blocks of consecutive voxels and a float cdf of the voxels relative to their block.
+    // this takes 4 bytes per voxel instead of 8, and the binary searches stay within the block table
+    // and a single block, which are small enough to remain in cache.
+    // the sampling and pdf() values agree exactly.
+
+    template<int N>
+    class hierarchical_raster_variate
+    {
+        typedef boost::uniform_real<> rand_type;
+        mutable rand_type m_rand;
+
+    public:
+        typedef double value_type;
+        enum { dimension = N };
+        template<typename Engine, typename OutputIterator>
+        inline double operator()(Engine& e, OutputIterator it) const {
+            double x = m_rand(e);
+            int block = int(std::upper_bound(m_block_cdf.begin()+1,m_block_cdf.end(),x)-(m_block_cdf.begin()+1));
+            if(block>=m_nblocks) block = m_nblocks-1;
+            double lo = m_block_cdf[block], hi = m_block_cdf[block+1];
+            // position within the block, kept below 1 so that it falls in the last voxel of positive pdf at most
+            double y = std::min((x-lo)/(hi-lo),1.-std::numeric_limits<double>::epsilon()/2);
+            std::vector<float>::const_iterator begin = m_cdf.begin()+block*m_block_size;
+            std::vector<float>::const_iterator end   = m_cdf.begin()+std::min((block+1)*m_block_size,m_totsize);
+            int offset = int(std::upper_bound(begin,end,y)-m_cdf.begin());
+            if(offset>=m_totsize) offset = m_totsize-1;
+            double pdf = voxel_pdf(offset);
+            for(int i=0; i<N; ++i)
+            {
+                int ix = offset % m_size[i];
+                *it++ = (ix+m_rand(e))/m_size[i];
+                offset /= m_size[i];
+            }
+            return pdf;
+        }
+        template<typename InputIterator>
+        inline double pdf(InputIterator it) const {
+            int offset = 0;
+            int stride = 1;
+            for(int i=0; i<N; ++i)
+            {
+                double x = *it++;
+                if(x<0. || x>=1.) return 0.;
+                int ix = int(x*m_size[i]);
+                offset += stride*ix;
+                stride *= m_size[i];
+            }
+            return voxel_pdf(offset);
+        }
+        template<typename T>
+        hierarchical_raster_variate(T* pdf, int *size, int block_size = 4096) : m_block_size(block_size) {
+            m_size.resize(N);
+            m_totsize = 1;
+            for(int i=0; i<N; ++i) { m_totsize *= size[i]; m_size[i] = size[i]; }
+            m_nblocks = (m_totsize+m_block_size-1)/m_block_size;
+            m_block_cdf.resize(m_nblocks+1);
+            m_cdf.resize(m_totsize);
+            double sum = 0;
+            m_block_cdf[0] = 0.;
+            for(int b=0; b<m_nblocks; ++b) {
+                int begin = b*m_block_size, end = std::min(begin+m_block_size,m_totsize);
+                double block_sum = 0;
+                for(int i=begin; i<end; ++i) block_sum += pdf[i]; // assert(pdf[i]>=0)
+                double c = 0;
+                for(int i=begin; i<end; ++i) {
+                    c += pdf[i];
+                    m_cdf[i] = (block_sum>0) ? float(c/block_sum) : 0.f;
+                }
+                if(block_sum>0) m_cdf[end-1] = 1.f;
+                m_block_cdf[b+1] = sum += block_sum;
+            }
+            for(int b=0; b<m_nblocks; ++b) m_block_cdf[b+1]/=sum;
+        }
+    private:
+        inline double voxel_pdf(int offset) const {
+            int block = offset/m_block_size;
+            double c0 = (offset==block*m_block_size) ? 0. : m_cdf[offset-1];
+            return (m_block_cdf[block+1]-m_block_cdf[block])*(m_cdf[offset]-c0)*m_totsize;
+        }
+
+        std::vector<double> m_block_cdf;
+        std::vector<float> m_cdf;
+        std::vector<int> m_size;
+        int m_totsize, m_nblocks, m_block_size;
+    };
+
+
+}; // namespace rjmcmc
+
+#endif // RJMCMC_HIERARCHICAL_RASTER_VARIATE_HPP
@@ -55,7 +55,7 @@ namespace rjmcmc {
         Variate1 m_variate1;
         Transform m_transform;
         mutable unsigned int m_kernel_id;
-        double m_p, m_p01, m_p10;
+        double m_p, m_q, m_p01, m_p10;
         std::string m_name[2];
 
     public:
@@ -65,16 +65,18 @@ namespace rjmcmc {
         inline void name(unsigned int i, const std::string& s) { m_name[i]=s; }
 
         kernel(const View0& v0, const View1& v1, const Variate0& x0, const Variate1& x1, const Transform& t, double p=1., double q=0.5) :
-                m_view0(v0), m_view1(v1), m_variate0(x0), m_variate1(x1), m_transform(t), m_p(p), m_p01(p*q), m_p10(p*(1-q))
+                m_view0(v0), m_view1(v1), m_variate0(x0), m_variate1(x1), m_transform(t), m_p(p), m_q(q), m_p01(p*q), m_p10(p*(1-q))
         {
             m_name[0]=m_name[1]="kernel";
         }
         kernel(double p=1., double q=0.5) :
-                m_view0(), m_view1(), m_variate0(), m_variate1(), m_transform(), m_p(p), m_p01(p*q), m_p10(p*(1.-q))
+                m_view0(), m_view1(), m_variate0(), m_variate1(), m_transform(), m_p(p), m_q(q), m_p01(p*q), m_p10(p*(1.-q))
         {
             m_name[0]=m_name[1]="kernel";
         }
         inline double probability() const { return m_p; }
+        // the branch probabilities keep their ratio
+        inline void probability(double p) { m_p = p; m_p01 = p*m_q; m_p10 = p*(1.-m_q); }
 
         // prerequisite : p is uniform between 0 and probability()=m_p
         template<typename Engine, typename Configuration, typename Modification>
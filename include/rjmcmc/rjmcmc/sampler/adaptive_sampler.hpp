@@ -0,0 +1,198 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+#ifndef ADAPTIVE_SAMPLER_HPP
+#define ADAPTIVE_SAMPLER_HPP
+
+#include <vector>
+#include <string>
+#include <ctime>
+#include <ostream>
+#include <iomanip>
+#include <boost/shared_ptr.hpp>
+
+namespace rjmcmc {
+
+    // Costs of the proposals of an adaptive_sampler : start() is called before a proposal, stop() returns its cost.
+
+    // deterministic cost : one unit per proposal, plus the unary and binary energy evaluations of the configuration
+    // (see unary_evaluations() and binary_evaluations()), so that the tuning does not depend on the timings
+    // and a seeded chain is reproducible
+    class evaluation_cost
+    {
+    public:
+        evaluation_cost() : m_start(0) {}
+        template<typename Configuration> inline void start(const Configuration& c) { m_start = evaluations(c); }
+        template<typename Configuration> inline double stop(const Configuration& c) const { return 1.+double(evaluations(c)-m_start); }
+        static inline const char *unit() { return "eval"; }
+    private:
+        template<typename Configuration> static inline unsigned long evaluations(const Configuration& c)
+        {
+            return c.unary_evaluations()+c.binary_evaluations();
+        }
+        unsigned long m_start;
+    };
+
+    // CPU time in microseconds, which depends on the load of the machine : seeded chains are not reproducible
+    class cpu_time_cost
+    {
+    public:
+        cpu_time_cost() : m_start(0) {}
+        template<typename Configuration> inline void start(const Configuration&) { m_start = std::clock(); }
+        template<typename Configuration> inline double stop(const Configuration&) const { return double(std::clock()-m_start)*1e6/CLOCKS_PER_SEC; }
+        static inline const char *unit() { return "us"; }
+    private:
+        std::clock_t m_start;
+    };
+
+    // Sampler wrapper tuning the probabilities of the kernels of the wrapped sampler during its first burnin() steps.
+    // Every period() steps, each kernel gets a share of the total probability that mixes its initial probability (weight floor())
+    // and its energy decrease per unit of Cost (weight 1-floor()), or its number of accepted proposals per unit of Cost
+    // while no energy decrease has been observed. The probabilities are frozen afterwards, so that the remaining of the chain
+    // is a regular RJMCMC chain satisfying detailed balance : burn-in samples should therefore be discarded.
+    // Copies share their statistics (so that the tuned probabilities may be reported from the original after the optimization
+    // of a copy wrapped in an any_sampler) : a sampler and its copies must thus be used by a single chain.
+    template<typename Sampler, typename Cost = evaluation_cost>
+    class adaptive_sampler : public Sampler
+    {
+        struct statistics {
+            unsigned int m_iteration;
+            std::vector<double> m_initial;     // initial kernel probabilities
+            std::vector<double> m_probability; // latest tuned kernel probabilities
+            std::vector<unsigned long> m_proposed, m_accepted;
+            std::vector<double> m_decrease;    // sum of the energy decreases of the accepted proposals
+            std::vector<double> m_cost;        // cost of the proposals, in Cost::unit()
+            Cost m_meter;
+        };
+    public:
+        enum { size = Sampler::size };
+
+        adaptive_sampler(const Sampler& s, unsigned int burnin, unsigned int period = 1000, double floor = 0.1) :
+                Sampler(s), m_burnin(burnin), m_period(period ? period : 1), m_floor(floor), m_stats(new statistics)
+        {
+            m_stats->m_iteration = 0;
+            for(unsigned int i=0; i<size; ++i) m_stats->m_initial.push_back(Sampler::probability(i));
+            m_stats->m_probability = m_stats->m_initial;
+            m_stats->m_proposed.assign(size,0);
+            m_stats->m_accepted.assign(size,0);
+            m_stats->m_decrease.assign(size,0.);
+            m_stats->m_cost    .assign(size,0.);
+        }
+
+        template<typename Engine, typename Configuration>
+        void operator()(Engine& e, Configuration &c, double temp)
+        {
+            statistics& s = *m_stats;
+            if(s.m_iteration>=m_burnin) { Sampler::operator()(e,c,temp); return; }
+
+            s.m_meter.start(c);
+            Sampler::operator()(e,c,temp);
+            double cost = s.m_meter.stop(c);
+
+            unsigned int i = Sampler::kernel_index();
+            if(i<size) {
+                ++s.m_proposed[i];
+                s.m_cost[i] += cost;
+                if(Sampler::accepted()) {
+                    ++s.m_accepted[i];
+                    if(Sampler::delta()<0) s.m_decrease[i] -= Sampler::delta();
+                }
+            }
+            ++s.m_iteration;
+            if(s.m_iteration%m_period==0 || s.m_iteration==m_burnin) update();
+        }
+
+        inline unsigned int burnin() const { return m_burnin; }
+        inline unsigned int period() const { return m_period; }
+        inline double floor() const { return m_floor; }
+        /// the probabilities are frozen once burnin() steps have been performed
+        inline bool frozen() const { return m_stats->m_iteration>=m_burnin; }
+
+        /// latest tuned probability of the ith kernel of the constructor of the wrapped sampler
+        inline double tuned_probability(unsigned int i) const { return m_stats->m_probability[i]; }
+        inline double initial_probability(unsigned int i) const { return m_stats->m_initial[i]; }
+        inline double acceptance_rate(unsigned int i) const
+        {
+            return m_stats->m_proposed[i] ? double(m_stats->m_accepted[i])/m_stats->m_proposed[i] : 0.;
+        }
+
+        /// prints, for each kernel, its initial and tuned probabilities and its burn-in statistics
+        void report(std::ostream& os) const
+        {
+            const statistics& s = *m_stats;
+            os << "Kernel probabilities tuned during " << s.m_iteration << " burn-in iterations" << std::endl;
+            os << std::setw(24) << "Kernel" << std::setw(12) << "Initial" << std::setw(12) << "Tuned"
+               << std::setw(12) << "Accept(%)" << std::setw(16) << (std::string("Decrease/")+Cost::unit()) << std::endl;
+            for(unsigned int i=0; i<size; ++i) {
+                std::string name;
+                for(unsigned int k=Sampler::kernel_begin(i); k<Sampler::kernel_begin(i+1); ++k)
+                    name += (name.empty() ? "" : "/") + Sampler::kernel_name(k);
+                os << std::setw(24) << name << std::setw(12) << s.m_initial[i] << std::setw(12) << s.m_probability[i]
+                   << std::setw(12) << 100.*acceptance_rate(i)
+                   << std::setw(16) << (s.m_cost[i]>0 ? s.m_decrease[i]/s.m_cost[i] : 0.) << std::endl;
+            }
+        }
+
+    private:
+        void update()
+        {
+            statistics& s = *m_stats;
+            double total = 0, decrease = 0, score_sum = 0;
+            for(unsigned int i=0; i<size; ++i) { total += s.m_initial[i]; decrease += s.m_decrease[i]; }
+            if(total<=0) return;
+            std::vector<double> score(size,0.);
+            for(unsigned int i=0; i<size; ++i) {
+                if(s.m_initial[i]<=0 || s.m_cost[i]<=0) continue; // disabled or not yet measured kernels are not scored
+                score[i] = (decrease>0 ? s.m_decrease[i] : s.m_accepted[i]) / s.m_cost[i];
+                score_sum += score[i];
+            }
+            if(score_sum<=0) return;
+            for(unsigned int i=0; i<size; ++i) {
+                double p = m_floor*s.m_initial[i] + (1-m_floor)*total*score[i]/score_sum;
+                s.m_probability[i] = p;
+                Sampler::probability(i,p);
+            }
+        }
+
+        unsigned int m_burnin;
+        unsigned int m_period;
+        double m_floor;
+        boost::shared_ptr<statistics> m_stats;
+    };
+
+}; // namespace rjmcmc
+
+#endif // ADAPTIVE_SAMPLER_HPP
@@ -42,6 +42,8 @@ knowledge of the CeCILL license and that you accept its terms.
 #include "rjmcmc/rjmcmc/kernel/kernel_traits.hpp"
 #include "rjmcmc/rjmcmc/kernel/kernel.hpp"
 #include <iomanip>
+#include <boost/mpl/bool.hpp>
+#include <boost/mpl/has_xxx.hpp>
 
 namespace rjmcmc {
 
@@ -69,6 +71,9 @@ namespace rjmcmc {
 
     namespace detail
     {
+        // acceptances defining the early_exit type draw their uniform variate before the energy variation
+        BOOST_MPL_HAS_XXX_TRAIT_DEF(early_exit)
+
         // statistics accessors
         template<typename K, unsigned int I, unsigned int N> struct get_name {
             inline const std::string& operator()(unsigned int i, const K& k) const {
@@ -94,6 +99,27 @@ namespace rjmcmc {
             inline unsigned int operator()(unsigned int i, const K& k) const { return 0; }
         };
 
+        template<typename K, unsigned int I, unsigned int N> struct get_kernel_begin {
+            inline unsigned int operator()(unsigned int i) const {
+                enum { ks = tuple_element<I,K>::type::size };
+                if(i<=I) return 0;
+                return ks+get_kernel_begin<K,I+1,N>()(i);
+            }
+        };
+        template<typename K, unsigned int N> struct get_kernel_begin<K,N,N> {
+            inline unsigned int operator()(unsigned int i) const { return 0; }
+        };
+
+        template<typename K, unsigned int I, unsigned int N> struct set_probability {
+            inline void operator()(unsigned int i, K& k, double p) const {
+                if(i==I) get<I>(k).probability(p);
+                else set_probability<K,I+1,N>()(i,k,p);
+            }
+        };
+        template<typename K, unsigned int N> struct set_probability<K,N,N> {
+            inline void operator()(unsigned int i, K& k, double p) const {}
+        };
+
         template<typename Engine, typename Configuration, typename Modification>
         struct kernel_functor
         {
@@ -118,7 +144,8 @@ namespace rjmcmc {
                 m_rand(0,1),
                 m_density(d),
                 m_acceptance(a),
-                m_kernel(RJMCMC_TUPLE_PARAMS)
+                m_kernel(RJMCMC_TUPLE_PARAMS),
+                m_selector(m_kernel)
         {}
 
 
@@ -135,7 +162,7 @@ namespace rjmcmc {
             Modification modif;
             m_temperature = temp;
             detail::kernel_functor<Engine,Configuration,Modification> kf(e,c,modif);
-            m_kernel_ratio = random_apply(m_kernel_id,m_rand(e),m_kernel,kf);
+            m_kernel_ratio = m_selector(m_kernel_id,m_rand(e),m_kernel,kf);
 
             //3
             m_ref_pdf_ratio = m_density.pdf_ratio(c,modif);
@@ -147,15 +174,35 @@ namespace rjmcmc {
                 m_accepted=false;
                 return;
             }
-            m_delta       = c.delta_energy(modif);
-            m_acceptance_probability  = m_acceptance(m_delta,m_temperature,m_green_ratio);
+            accept(e,c,modif,boost::mpl::bool_<detail::has_early_exit<Acceptance>::value>());
 
             //5
-            m_accepted    = ( m_rand(e) < m_acceptance_probability );
             if (m_accepted) modif.apply(c);
             //modif.apply(c,m_accepted);
         }
 
+    private:
+        // the configuration is not const, so that it counts the binary energy evaluations of delta_energy
+        template<typename Engine, typename Configuration, typename Modification>
+        inline void accept(Engine& e, Configuration &c, const Modification& modif, boost::mpl::false_)
+        {
+            m_delta       = c.delta_energy(modif);
+            m_acceptance_probability  = m_acceptance(m_delta,m_temperature,m_green_ratio);
+            m_accepted    = ( m_rand(e) < m_acceptance_probability );
+        }
+
+        // the uniform variate is drawn first, the configuration may then stop the evaluation of the energy variation
+        // as soon as it exceeds the maximum admissible one : delta() is then only a lower bound of the energy variation
+        template<typename Engine, typename Configuration, typename Modification>
+        inline void accept(Engine& e, Configuration &c, const Modification& modif, boost::mpl::true_)
+        {
+            double u = m_rand(e);
+            double max_delta = m_acceptance.max_delta(u,m_temperature,m_green_ratio);
+            m_delta       = c.delta_energy(modif,max_delta);
+            m_acceptance_probability  = m_acceptance(m_delta,m_temperature,m_green_ratio);
+            m_accepted    = ( m_delta <= max_delta && u < m_acceptance_probability );
+        }
+
     public:
         ///  Getting the density of the reference process
         inline const Density& density() const { return m_density; }
@@ -169,12 +216,29 @@ namespace rjmcmc {
         ///  statistics accessor : getting the number of kernels
         inline unsigned int kernel_size() const { return m_kernel_size; }
 
+        ///  statistics accessor : getting the index of the latest proposed kernel of the constructor
+        inline unsigned int kernel_index() const { return m_kernel_id; }
+
+        ///  the ith kernel of the constructor has the kernel_name()s of indices [kernel_begin(i),kernel_begin(i+1))
+        inline unsigned int kernel_begin(unsigned int i) const { return detail::get_kernel_begin<Kernels,0,size>()(i); }
+
+        ///  getting the probability of the ith kernel of the constructor (a kernel may have several kernel_name()s)
+        inline double probability(unsigned int i) const { return m_selector.probability(i); }
+
+        ///  setting the probability of the ith kernel of the constructor
+        void probability(unsigned int i, double p)
+        {
+            detail::set_probability<Kernels,0,size>()(i,m_kernel,p);
+            m_selector.update(m_kernel);
+        }
+
     private:
         // data
         boost::uniform_real<> m_rand;
         Density    m_density;
         Acceptance m_acceptance;
         Kernels    m_kernel;
+        random_selector<Kernels> m_selector; // kernel probabilities are cached
 
         // statistics
         unsigned int m_kernel_id;
@@ -0,0 +1,283 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+#ifndef DOMAIN_DECOMPOSITION_HPP
+#define DOMAIN_DECOMPOSITION_HPP
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <boost/shared_ptr.hpp>
+#include <boost/concept_check.hpp>
+#include <boost/random/uniform_real.hpp>
+#include "rjmcmc/util/parallel_for.hpp"
+#include "visitor/null_visitor.hpp"
+#include "rjmcmc/mpp/configuration/graph_configuration.hpp"
+#include "rjmcmc/mpp/configuration/flat_graph_configuration.hpp"
+#include "rjmcmc/mpp/configuration/rtree_accelerator.hpp"
+#include "rjmcmc/mpp/energy/halo_unary_energy.hpp"
+
+namespace marked_point_process {
+
+    // local_configuration<C>::type is the configuration type used to sample the objects of a single cell of a configuration of type C :
+    // its unary energy accounts for the frozen objects of the halo of the cell, and its neighbours are found by an R*-tree.
+    template<typename Configuration> struct local_configuration;
+
+    template<typename T, typename U, typename B, typename A, typename O, typename V>
+    struct local_configuration< graph_configuration<T,U,B,A,O,V> > {
+        typedef halo_unary_energy<U,B,T> unary_energy;
+        typedef graph_configuration<T,unary_energy,B,rtree_accelerator,O,V> type;
+    };
+
+    template<typename T, typename U, typename B, typename A>
+    struct local_configuration< flat_graph_configuration<T,U,B,A> > {
+        typedef halo_unary_energy<U,B,T> unary_energy;
+        typedef flat_graph_configuration<T,unary_energy,B,rtree_accelerator> type;
+    };
+
+}; // namespace marked_point_process
+
+namespace simulated_annealing
+{
+    namespace internal
+    {
+        template<typename Engine, typename Configuration, typename Sampler, typename Handle>
+        struct cell_task
+        {
+            Engine engine;
+            Configuration config;
+            Sampler sampler;
+            std::vector<Handle> owned;
+            unsigned int accepted;
+            cell_task(const Engine& e, const Configuration& c, const Sampler& s) : engine(e), config(c), sampler(s), accepted(0) {}
+        };
+
+        template<typename Task> struct cell_runner
+        {
+            std::vector< boost::shared_ptr<Task> >& m_tasks;
+            const std::vector<double>& m_temp;
+            cell_runner(std::vector< boost::shared_ptr<Task> >& tasks, const std::vector<double>& temp) : m_tasks(tasks), m_temp(temp) {}
+            void operator()(unsigned int i) const
+            {
+                Task& t = *m_tasks[i];
+                for(unsigned int j=0; j<m_temp.size(); ++j)
+                {
+                    t.sampler(t.engine,t.config,m_temp[j]);
+                    if(t.sampler.accepted()) ++t.accepted;
+                }
+            }
+        };
+
+        inline int clamp_cell(double x, int n) { return std::max(0,std::min(n-1,int(std::floor(x)))); }
+    }; // namespace internal
+
+    /**
+     * Spatially decomposed version of optimize, for configurations of objects spread over a large domain.
+     *
+     * The domain is partitioned into square cells of side cell_size, coloured as a 2x2 chequerboard. Each phase samples
+     * all the cells of one colour concurrently, on nthreads threads (0 : one per hardware core), for 'iterations' iterations each.
+     * Each cell samples the objects whose bounding box center lies in the cell, the other objects being frozen.
+     * The cells are not sampled in place on config : the objects of each cell are copied into a local configuration
+     * (marked_point_process::local_configuration) whose unary energy, marked_point_process::halo_unary_energy, accounts for
+     * the frozen objects around the cell, and the local configurations of the modified cells are merged back into config
+     * at the end of each phase. The partition is randomly shifted every 4 phases, so that objects move across cell borders.
+     *
+     * Requirements :
+     * - objects whose bounding boxes are farther apart than range do not interact,
+     * - the bounding boxes of the objects are smaller than (cell_size-range)/2 in every direction from their center,
+     *   so that cells of the same colour never interact (larger objects are rejected within the cells),
+     * - iterators of config stay valid when other objects are removed (graph_configuration, flat_graph_configuration).
+     *
+     * factory(cell,n) returns the sampler of a cell, given the cell (clipped to the domain) and the number n of objects outside it
+     * at the beginning of the phase. Its reference process should be the restriction of the reference process to the cell.
+     *
+     * The decomposition is exact when the reference process factorizes over disjoint cells. This is the case of a poisson
+     * reference process with uniform births : its restriction to a cell is the poisson process of mean the global mean times
+     * the relative area of the cell, independently of the other cells, and n is not needed. Reference processes whose Green
+     * ratios depend on the total number of objects do not factorize. Their count may be shifted by n (see rjmcmc::shifted_distribution),
+     * but n is frozen during the phase while the other cells of the phase concurrently change their counts :
+     * the cell chains are then only approximately correct.
+     *
+     * The schedule is advanced by 'iterations' at each phase, the end test and the visitor are called once per phase,
+     * the visitor being passed the sampler of the last cell sampled. Returns the number of phases.
+     */
+    template<
+            typename Engine,
+            typename Configuration, typename SamplerFactory,
+            typename Schedule, typename EndTest,
+            typename Visitor
+            >
+            unsigned int domain_decomposition(
+                    Engine& e,
+                    Configuration& config, const SamplerFactory& factory,
+                    Schedule& schedule, EndTest& end_test,
+                    Visitor& visitor,
+                    const marked_point_process::bounding_box& domain,
+                    double cell_size, double range,
+                    unsigned int iterations,
+                    unsigned int nthreads=0)
+    {
+        BOOST_CONCEPT_ASSERT((boost::InputIterator<Schedule>));
+
+        typedef marked_point_process::bounding_box bounding_box;
+        typedef typename SamplerFactory::result_type Sampler;
+        typedef marked_point_process::local_configuration<Configuration> local;
+        typedef typename local::type local_configuration;
+        typedef typename local::unary_energy local_unary_energy;
+        typedef typename local_unary_energy::halo_type halo_type;
+        typedef typename Configuration::const_iterator handle;
+        typedef internal::cell_task<Engine,local_configuration,Sampler,handle> task;
+
+        const double inf = std::numeric_limits<double>::infinity();
+        const double extent = 0.5*(cell_size-range);
+        boost::uniform_real<> die(0,1);
+        std::vector<double> temp(std::max<unsigned int>(iterations,1));
+        double ox = 0, oy = 0;
+
+        boost::shared_ptr<task> last(new task(e, local_configuration(
+                local_unary_energy(config.unary_energy_functor(),config.binary_energy_functor(),domain,domain,range,boost::shared_ptr<const halo_type>(new halo_type)),
+                config.binary_energy_functor(), marked_point_process::rtree_accelerator(range)), factory(domain,0)));
+
+        double t = *schedule;
+        visitor.begin(config,last->sampler,t);
+        unsigned int phase = 0;
+        for(; !end_test(config,last->sampler,t); ++phase)
+        {
+            if(phase%4==0)
+            {
+                ox = cell_size*die(e);
+                oy = cell_size*die(e);
+            }
+            unsigned int ci = phase%2, cj = (phase/2)%2; // colour of the active cells
+            double x0 = domain.xmin-ox, y0 = domain.ymin-oy;
+            int nx = std::max(1,int(std::ceil((domain.xmax-x0)/cell_size)));
+            int ny = std::max(1,int(std::ceil((domain.ymax-y0)/cell_size)));
+
+            // active cells, with infinite borders so that all objects are owned
+            std::vector<int> index(nx*ny,-1);
+            std::vector<bounding_box> cells;
+            std::vector< boost::shared_ptr<halo_type> > halos;
+            std::vector< std::vector<handle> > owned;
+            for(int j=cj; j<ny; j+=2)
+                for(int i=ci; i<nx; i+=2)
+                {
+                    index[i+nx*j] = cells.size();
+                    cells.push_back(bounding_box(
+                            i==0 ? -inf : x0+i*cell_size, j==0 ? -inf : y0+j*cell_size,
+                            i==nx-1 ? inf : x0+(i+1)*cell_size, j==ny-1 ? inf : y0+(j+1)*cell_size));
+                    halos.push_back(boost::shared_ptr<halo_type>(new halo_type));
+                }
+            owned.resize(cells.size());
+
+            // objects of the active cells and of their halos
+            const double d = extent+range;
+            for(handle it=config.begin(); it!=config.end(); ++it)
+            {
+                bounding_box b = marked_point_process::get_bounding_box(config.value(it));
+                int i = internal::clamp_cell((0.5*(b.xmin+b.xmax)-x0)/cell_size,nx);
+                int j = internal::clamp_cell((0.5*(b.ymin+b.ymax)-y0)/cell_size,ny);
+                int k = index[i+nx*j];
+                if(k>=0) owned[k].push_back(it);
+                int i0 = internal::clamp_cell((b.xmin-d-x0)/cell_size,nx), i1 = internal::clamp_cell((b.xmax+d-x0)/cell_size,nx);
+                int j0 = internal::clamp_cell((b.ymin-d-y0)/cell_size,ny), j1 = internal::clamp_cell((b.ymax+d-y0)/cell_size,ny);
+                for(int jj=j0; jj<=j1; ++jj)
+                    for(int ii=i0; ii<=i1; ++ii)
+                    {
+                        int h = index[ii+nx*jj];
+                        if(h>=0 && h!=k && cells[h].dilate(d).intersects(b))
+                            halos[h]->push_back(std::make_pair(b,config.value(it)));
+                    }
+            }
+
+            // cell chains, seeded from e
+            std::vector< boost::shared_ptr<task> > tasks(cells.size());
+            for(unsigned int k=0; k<cells.size(); ++k)
+            {
+                const bounding_box& c = cells[k];
+                local_unary_energy unary(config.unary_energy_functor(),config.binary_energy_functor(),
+                                         c,c.dilate(extent),range,halos[k]);
+                bounding_box clipped(std::max(c.xmin,domain.xmin),std::max(c.ymin,domain.ymin),
+                                     std::min(c.xmax,domain.xmax),std::min(c.ymax,domain.ymax));
+                tasks[k].reset(new task(e,local_configuration(unary,config.binary_energy_functor(),marked_point_process::rtree_accelerator(range)),
+                                        factory(clipped,config.size()-owned[k].size())));
+                tasks[k]->engine.seed(e());
+                tasks[k]->owned.swap(owned[k]);
+                for(typename std::vector<handle>::const_iterator it=tasks[k]->owned.begin(); it!=tasks[k]->owned.end(); ++it)
+                    tasks[k]->config.insert(config.value(*it));
+            }
+
+            for(unsigned int j=0; j<temp.size(); ++j, ++schedule) temp[j] = *schedule;
+            rjmcmc::parallel_for(tasks.size(), internal::cell_runner<task>(tasks,temp), nthreads);
+
+            // merge the modified cells back
+            for(unsigned int k=0; k<tasks.size(); ++k)
+            {
+                task& tk = *tasks[k];
+                if(!tk.accepted) continue;
+                for(typename std::vector<handle>::const_iterator it=tk.owned.begin(); it!=tk.owned.end(); ++it)
+                    config.remove(*it);
+                for(typename local_configuration::const_iterator it=tk.config.begin(); it!=tk.config.end(); ++it)
+                    config.insert(tk.config.value(it));
+            }
+            if(!tasks.empty()) last = tasks.back();
+            t = *schedule;
+            visitor.visit(config,last->sampler,temp.back());
+        }
+        visitor.end(config,last->sampler,t);
+        return phase;
+    }
+
+    template<
+            typename Engine,
+            typename Configuration, typename SamplerFactory,
+            typename Schedule, typename EndTest
+            >
+            unsigned int domain_decomposition(
+                    Engine& e,
+                    Configuration& config, const SamplerFactory& factory,
+                    Schedule& schedule, EndTest& end_test,
+                    const marked_point_process::bounding_box& domain,
+                    double cell_size, double range,
+                    unsigned int iterations,
+                    unsigned int nthreads=0)
+    {
+        null_visitor visitor;
+        return domain_decomposition(e,config,factory,schedule,end_test,visitor,domain,cell_size,range,iterations,nthreads);
+    }
+}
+
+#endif // DOMAIN_DECOMPOSITION_HPP
@@ -0,0 +1,137 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+#ifndef MULTI_START_HPP
+#define MULTI_START_HPP
+
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include "rjmcmc/util/random.hpp"
+#include "rjmcmc/util/parallel_for.hpp"
+#include "simulated_annealing.hpp"
+
+namespace simulated_annealing
+{
+    // statistics of one of the runs of multi_start_optimize
+    struct run_statistics {
+        unsigned int   run;
+        boost::uint64_t seed;       // seed of the engine of the run (see rjmcmc::seed_engine)
+        double         energy;     // final energy
+        unsigned int   iterations;
+        double         time;       // wall-clock time, in seconds
+    };
+
+    namespace internal
+    {
+        template<typename Engine, typename Configuration, typename Sampler, typename Schedule, typename EndTest>
+        struct multi_start_run
+        {
+            boost::uint64_t m_seed;
+            const Configuration& m_config;
+            const Sampler& m_sampler;
+            const Schedule& m_schedule;
+            const EndTest& m_end_test;
+            std::vector<run_statistics>& m_stats;
+            Configuration& m_best;
+            int& m_best_run;
+            boost::mutex& m_mutex;
+
+            multi_start_run(boost::uint64_t seed, const Configuration& config, const Sampler& sampler,
+                            const Schedule& schedule, const EndTest& end_test,
+                            std::vector<run_statistics>& stats, Configuration& best, int& best_run, boost::mutex& m)
+                                : m_seed(seed), m_config(config), m_sampler(sampler), m_schedule(schedule), m_end_test(end_test)
+                                , m_stats(stats), m_best(best), m_best_run(best_run), m_mutex(m) {}
+
+            void operator()(unsigned int i) const
+            {
+                using namespace boost::posix_time;
+                run_statistics& stats = m_stats[i];
+                stats.run  = i;
+                stats.seed = rjmcmc::stream_seed(m_seed,i);
+                Engine e;
+                rjmcmc::seed_engine(e,stats.seed);
+                Configuration config(m_config);
+                Sampler  sampler (m_sampler);
+                Schedule schedule(m_schedule);
+                EndTest  end_test(m_end_test);
+                ptime start = microsec_clock::universal_time();
+                stats.iterations = optimize(e,config,sampler,schedule,end_test);
+                stats.time   = (microsec_clock::universal_time()-start).total_microseconds()*1e-6;
+                stats.energy = config.energy();
+
+                boost::mutex::scoped_lock lock(m_mutex);
+                // ties are broken by the run index, so that the result does not depend on the thread scheduling
+                if(m_best_run<0 || stats.energy<m_stats[m_best_run].energy || (stats.energy==m_stats[m_best_run].energy && int(i)<m_best_run))
+                {
+                    m_best = config;
+                    m_best_run = i;
+                }
+            }
+        };
+    }; // namespace internal
+
+    /**
+     * Runs 'runs' independent simulated annealings of config, on nthreads threads (0 : one per hardware core).
+     * Each run starts from a copy of config, sampler, schedule and end_test, with an engine of type Engine
+     * seeded by rjmcmc::stream_seed(seed,i), so that the results are reproducible whatever the number of threads.
+     * On return, config holds the lowest energy final configuration, and the statistics of each run are returned, in run order.
+     */
+    template<
+            typename Engine,
+            typename Configuration, typename Sampler,
+            typename Schedule, typename EndTest
+            >
+            std::vector<run_statistics> multi_start_optimize(
+                    boost::uint64_t seed, unsigned int runs,
+                    Configuration& config, const Sampler& sampler,
+                    const Schedule& schedule, const EndTest& end_test,
+                    unsigned int nthreads=0)
+    {
+        std::vector<run_statistics> stats(runs);
+        if(runs==0) return stats;
+        Configuration best(config);
+        int best_run = -1;
+        boost::mutex mutex;
+        internal::multi_start_run<Engine,Configuration,Sampler,Schedule,EndTest> run(seed,config,sampler,schedule,end_test,stats,best,best_run,mutex);
+        rjmcmc::parallel_for(runs,run,nthreads);
+        config = best;
+        return stats;
+    }
+}
+
+#endif // MULTI_START_HPP
@@ -0,0 +1,224 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+#ifndef PARALLEL_TEMPERING_HPP
+#define PARALLEL_TEMPERING_HPP
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <boost/concept_check.hpp>
+#include <boost/random/uniform_real.hpp>
+#include "rjmcmc/util/parallel_for.hpp"
+#include "visitor/null_visitor.hpp"
+
+namespace simulated_annealing
+{
+    /**
+     * \ingroup GroupSchedule
+     *
+     * Temperature multipliers 1, r, r^2, ..., r^(n-1) of a geometric ladder of n replicas.
+     * Replica k runs at the temperature given by the schedule, multiplied by the k-th ladder value.
+     */
+    inline std::vector<double> geometric_ladder(unsigned int n, double ratio)
+    {
+        std::vector<double> ladder(n);
+        double m = 1.;
+        for(unsigned int k=0; k<n; ++k, m*=ratio) ladder[k] = m;
+        return ladder;
+    }
+
+    namespace internal
+    {
+        // one round of parallel tempering : each replica performs (at most) temp.size() iterations.
+        // Only the replica at the coldest level tests the end condition and is visited.
+        template<typename Engine, typename Configuration, typename Sampler, typename EndTest, typename Visitor>
+        struct tempering_round
+        {
+            std::vector<Engine*>& m_e;
+            std::vector<Configuration*>& m_c;
+            std::vector<Sampler*>& m_s;
+            const std::vector<unsigned int>& m_level;
+            const std::vector<double>& m_ladder;
+            const std::vector<double>& m_temp;
+            EndTest& m_end_test;
+            Visitor& m_visitor;
+            unsigned int m_iterations;
+            bool m_stop;
+
+            tempering_round(std::vector<Engine*>& e, std::vector<Configuration*>& c, std::vector<Sampler*>& s,
+                            const std::vector<unsigned int>& level, const std::vector<double>& ladder,
+                            const std::vector<double>& temp, EndTest& end_test, Visitor& visitor)
+                                : m_e(e), m_c(c), m_s(s), m_level(level), m_ladder(ladder), m_temp(temp)
+                                , m_end_test(end_test), m_visitor(visitor), m_iterations(0), m_stop(false) {}
+
+            void operator()(unsigned int r)
+            {
+                Engine& e = *m_e[r];
+                Configuration& c = *m_c[r];
+                Sampler& s = *m_s[r];
+                unsigned int n = m_temp.size();
+                if(m_level[r]==0)
+                {
+                    unsigned int j=0;
+                    for(; j<n && !m_end_test(c,s,m_temp[j]); ++j)
+                    {
+                        s(e,c,m_temp[j]);
+                        m_visitor.visit(c,s,m_temp[j]);
+                    }
+                    m_iterations = j;
+                    m_stop = (j<n);
+                    return;
+                }
+                double m = m_ladder[m_level[r]];
+                for(unsigned int j=0; j<n; ++j) s(e,c,m*m_temp[j]);
+            }
+        };
+
+        // parallel_for copies its functor : this forwards to a shared round
+        template<typename Round> struct round_ref {
+            Round& m_r;
+            round_ref(Round& r) : m_r(r) {}
+            void operator()(unsigned int i) const { m_r(i); }
+        };
+    }; // namespace internal
+
+    /**
+     * Replica exchange (parallel tempering) version of optimize.
+     *
+     * ladder.size() replicas of config evolve concurrently, on nthreads threads (0 : one per hardware core),
+     * replica k at the temperature of the schedule multiplied by ladder[k] (ladder[0] should be 1).
+     * Every 'interval' iterations, swaps of the configurations of adjacent levels are proposed with the
+     * Metropolis criterion min(1, exp((E_k - E_k+1)(1/T_k - 1/T_k+1))), alternating between even and odd pairs.
+     *
+     * The schedule, the end test and the visitor follow the coldest replica only, so that existing models of
+     * the EndTest and Visitor concepts can be reused. The end test is evaluated (and the visitor notified) at every
+     * iteration, but the other replicas only stop at the end of the current round.
+     * On return, config holds the coldest replica. Replicas use copies of the sampler, and engines seeded from e.
+     * Returns the number of iterations of the coldest replica.
+     */
+    template<
+            typename Engine,
+            typename Configuration, typename Sampler,
+            typename Schedule, typename EndTest,
+            typename Visitor
+            >
+            unsigned int parallel_tempering(
+                    Engine& e,
+                    Configuration& config, Sampler& sampler,
+                    Schedule& schedule, EndTest& end_test,
+                    Visitor& visitor,
+                    const std::vector<double>& ladder,
+                    unsigned int interval,
+                    unsigned int nthreads=0)
+    {
+        BOOST_CONCEPT_ASSERT((boost::InputIterator<Schedule>));
+
+        unsigned int n = std::max<unsigned int>(ladder.size(),1);
+        std::vector<Configuration> configs(n-1,config);
+        std::vector<Sampler>       samplers(n-1,sampler);
+        std::vector<Engine>        engines(n-1,e);
+        std::vector<Configuration*> c(n);
+        std::vector<Sampler*>       s(n);
+        std::vector<Engine*>        g(n);
+        std::vector<unsigned int>   level(n), replica(n); // level of each replica, and its inverse
+        c[0] = &config;
+        s[0] = &sampler;
+        g[0] = &e;
+        for(unsigned int r=1; r<n; ++r)
+        {
+            c[r] = &configs[r-1];
+            s[r] = &samplers[r-1];
+            g[r] = &engines[r-1];
+            g[r]->seed(e());
+        }
+        for(unsigned int k=0; k<n; ++k) level[k] = replica[k] = k;
+        std::vector<double> unit_ladder(1,1.);
+        const std::vector<double>& l = ladder.empty() ? unit_ladder : ladder;
+
+        boost::uniform_real<> die(0,1);
+        std::vector<double> temp(std::max<unsigned int>(interval,1));
+        double t = *schedule;
+        unsigned int iterations = 0;
+        visitor.begin(config,sampler,t);
+        for(unsigned int round=0; ; ++round)
+        {
+            for(unsigned int j=0; j<temp.size(); ++j, ++schedule) temp[j] = *schedule;
+            internal::tempering_round<Engine,Configuration,Sampler,EndTest,Visitor> r(g,c,s,level,l,temp,end_test,visitor);
+            rjmcmc::parallel_for(n, internal::round_ref<internal::tempering_round<Engine,Configuration,Sampler,EndTest,Visitor> >(r), nthreads);
+            iterations += r.m_iterations;
+            t = temp[r.m_iterations<temp.size() ? r.m_iterations : temp.size()-1];
+            if(r.m_stop) break;
+
+            // replica exchange between adjacent levels
+            for(unsigned int k=round%2; k+1<n; k+=2)
+            {
+                unsigned int a = replica[k], b = replica[k+1];
+                double delta = (c[a]->energy()-c[b]->energy())*(1./(t*l[k])-1./(t*l[k+1]));
+                if(delta>=0 || die(e)<std::exp(delta))
+                {
+                    std::swap(replica[k],replica[k+1]);
+                    level[a] = k+1;
+                    level[b] = k;
+                }
+            }
+        }
+
+        unsigned int cold = replica[0];
+        if(cold!=0) config = *c[cold];
+        visitor.end(config,*s[cold],t);
+        return iterations;
+    }
+
+    template<
+            typename Engine,
+            typename Configuration, typename Sampler,
+            typename Schedule, typename EndTest
+            >
+            unsigned int parallel_tempering(
+                    Engine& e,
+                    Configuration& config, Sampler& sampler,
+                    Schedule& schedule, EndTest& end_test,
+                    const std::vector<double>& ladder,
+                    unsigned int interval,
+                    unsigned int nthreads=0)
+    {
+        null_visitor visitor;
+        return parallel_tempering(e,config,sampler,schedule,end_test,visitor,ladder,interval,nthreads);
+    }
+}
+
+#endif // PARALLEL_TEMPERING_HPP
@@ -65,6 +65,7 @@ namespace simulated_annealing {
 
         unsigned int m_dump;
         unsigned int m_iter;
+        unsigned long m_binary_evaluations;
         int w;
 	int p;
         std::ostream& m_out;
@@ -113,6 +114,7 @@ namespace simulated_annealing {
             m_out << std::setw(w) << "Accepted";
             m_out << std::setw(w) << "Kernel_ratio";
             m_out << std::setw(w) << "Ref_pdf_ratio";
+            m_out << std::setw(w) << "Binary_evals";
 
             if(m_add_endline)
                 m_out << std::endl;
@@ -123,7 +125,7 @@ namespace simulated_annealing {
 #else
         m_clock_begin = m_clock = clock();
 #endif
-	    
+            m_binary_evaluations = config.binary_evaluations();
         }
         template<typename Configuration, typename Sampler>
         void end(const Configuration& config, const Sampler&, double)
@@ -140,6 +142,10 @@ namespace simulated_annealing {
             m_out << "Graph Data energy integrity : " << config.audit_unary_energy() << "=" << config.unary_energy() << std::endl;
             m_out << "Graph Prior energy integrity: " << config.audit_binary_energy() << "=" << config.binary_energy()<< std::endl;
             m_out << "Graph Structure integrity : " << config.audit_structure() << std::endl;
+            m_out << "Interaction candidates : " << config.pruning_statistics().candidates
+                  << " (bbox pruned : " << config.pruning_statistics().bbox_pruned
+                  << ", interact pruned : " << config.pruning_statistics().interact_pruned
+                  << ", evaluated : " << config.pruning_statistics().evaluated << ")" << std::endl;
             //  m_out << config;
             m_out << std::endl << std::flush;
         }
@@ -186,6 +192,9 @@ namespace simulated_annealing {
                 m_out << std::setw(w) << std::setprecision(p) << sampler.accepted();
                 m_out << std::setw(w) << std::setprecision(p) << sampler.kernel_ratio();
                 m_out << std::setw(w) << std::setprecision(p) << sampler.ref_pdf_ratio();
+                // binary energy evaluations per iteration since the last dump
+                m_out << std::setw(w) << std::setprecision(p) << double(config.binary_evaluations()-m_binary_evaluations) / m_dump;
+                m_binary_evaluations = config.binary_evaluations();
 
                 if(m_add_endline)
                     m_out << std::endl;
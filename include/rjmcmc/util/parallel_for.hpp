@@ -0,0 +1,99 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+#ifndef PARALLEL_FOR_HPP
+#define PARALLEL_FOR_HPP
+
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+
+namespace rjmcmc {
+
+    namespace internal {
+        template<typename F> struct parallel_for_worker {
+            F& m_f;
+            unsigned int m_n;
+            unsigned int& m_next;
+            boost::mutex& m_mutex;
+            parallel_for_worker(F& f, unsigned int n, unsigned int& next, boost::mutex& m) : m_f(f), m_n(n), m_next(next), m_mutex(m) {}
+            void operator()() const
+            {
+                for(;;)
+                {
+                    unsigned int i;
+                    {
+                        boost::mutex::scoped_lock lock(m_mutex);
+                        if(m_next>=m_n) return;
+                        i = m_next++;
+                    }
+                    m_f(i);
+                }
+            }
+        };
+    }; // namespace internal
+
+    // number of threads used for a requested count : 0 means one thread per hardware core
+    inline unsigned int thread_count(unsigned int nthreads)
+    {
+        if(nthreads==0) nthreads = boost::thread::hardware_concurrency();
+        return nthreads ? nthreads : 1;
+    }
+
+    // calls f(i) for each i in [0,n), on at most nthreads threads (0 : one per hardware core).
+    // Indices are handed out dynamically, so that tasks of uneven cost are balanced.
+    // f(i) may be called concurrently for distinct values of i and should not throw.
+    template<typename F>
+    void parallel_for(unsigned int n, F f, unsigned int nthreads=0)
+    {
+        nthreads = thread_count(nthreads);
+        if(nthreads>n) nthreads = n;
+        if(nthreads<=1)
+        {
+            for(unsigned int i=0; i<n; ++i) f(i);
+            return;
+        }
+        unsigned int next = 0;
+        boost::mutex mutex;
+        internal::parallel_for_worker<F> worker(f,n,next,mutex);
+        boost::thread_group threads;
+        for(unsigned int t=1; t<nthreads; ++t) threads.create_thread(worker);
+        worker(); // the calling thread takes its share
+        threads.join_all();
+    }
+
+}; // namespace rjmcmc
+
+#endif // PARALLEL_FOR_HPP
@@ -38,34 +38,140 @@ knowledge of the CeCILL license and that you accept its terms.
 #define RANDOM_HPP
 
 #include <boost/random.hpp>
+#include <boost/random/seed_seq.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/atomic.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+#include "random_engine.hpp"
 
 #ifndef _WINDOWS
 #	include <sys/time.h>
 #	include <unistd.h>
+#else
+#	include <ctime>
 #endif
 
 namespace rjmcmc {
 
     typedef boost::mt19937 mt19937_generator;
+    typedef xoshiro256pp   xoshiro256pp_generator;
+    typedef pcg32          pcg32_generator;
 
-    /**
- * @fn static RJMCMCRandom &GetRandom() Simple function which return an initialised random number generator
- * @todo Properly handle Windows platform
- */
-    static mt19937_generator &random()
+    // engine type of rjmcmc::random(), selected at compile time (mt19937 by default)
+#if defined(RJMCMC_USE_XOSHIRO256PP)
+    typedef xoshiro256pp_generator generator;
+#elif defined(RJMCMC_USE_PCG32)
+    typedef pcg32_generator        generator;
+#else
+    typedef mt19937_generator      generator;
+#endif
+
+    // splitmix64 finalizer : a bijective mixing of 64 bits
+    inline boost::uint64_t splitmix64(boost::uint64_t x)
+    {
+        x += 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
+    // seed of the i-th independent stream derived from a master seed :
+    // deterministic, and decorrelated for neighbouring masters and streams
+    inline boost::uint64_t stream_seed(boost::uint64_t master, boost::uint64_t i)
+    {
+        return splitmix64(splitmix64(master) ^ splitmix64(~i));
+    }
+
+    // seeds e with the 64 bits of s : engines with 32 bits seeds (e.g. mt19937) are seeded through a seed sequence
+    template<typename Engine>
+    inline void seed_engine(Engine& e, boost::uint64_t s)
     {
-        static mt19937_generator g;
-#ifndef WIN32
-	static bool uninitialised = true;
-	if (uninitialised)
-	{
+        boost::uint32_t v[2] = { boost::uint32_t(s), boost::uint32_t(s >> 32) };
+        boost::random::seed_seq seq(v, v+2);
+        e.seed(seq);
+    }
+    inline void seed_engine(xoshiro256pp& e, boost::uint64_t s) { e.seed(s); }
+    inline void seed_engine(pcg32& e, boost::uint64_t s) { e.seed(s); }
+
+    namespace internal {
+        inline boost::uint64_t time_seed()
+        {
+#ifndef _WINDOWS
             struct timeval tv;
             gettimeofday(&tv, 0);
-            g.seed(tv.tv_sec + tv.tv_usec);
-            uninitialised = false;
-	}
+            return boost::uint64_t(tv.tv_sec)*1000000 + tv.tv_usec;
+#else
+            return boost::uint64_t(std::time(0));
 #endif
-	return g;
+        }
+
+        // master seed of the process, and numbering of the streams of the threads.
+        // generation is only modified under the mutex, but it is read without it by the engines that are already seeded
+        struct engine_registry {
+            boost::mutex    mutex;
+            boost::uint64_t master;
+            boost::atomic<unsigned int> generation; // incremented by each explicit seeding
+            unsigned int    next_stream;
+            engine_registry() : master(time_seed()), generation(0), next_stream(0) {}
+        };
+        inline engine_registry& registry() { static engine_registry r; return r; }
+
+        struct thread_engine {
+            generator    engine;
+            unsigned int generation;
+        };
+        inline boost::thread_specific_ptr<thread_engine>& thread_engines()
+        {
+            static boost::thread_specific_ptr<thread_engine> p;
+            return p;
+        }
+    }; // namespace internal
+
+    // sets the master seed of the process. Unless seeded, the master seed is drawn from the clock.
+    // The engines of rjmcmc::random() are reseeded on their next use, and streams are renumbered from 0.
+    inline void seed(boost::uint64_t s)
+    {
+        internal::engine_registry& r = internal::registry();
+        boost::mutex::scoped_lock lock(r.mutex);
+        r.master = s;
+        r.next_stream = 0;
+        r.generation.fetch_add(1, boost::memory_order_release);
+    }
+
+    inline boost::uint64_t master_seed()
+    {
+        internal::engine_registry& r = internal::registry();
+        boost::mutex::scoped_lock lock(r.mutex);
+        return r.master;
+    }
+
+    // independent engine of the i-th stream of the master seed, for per-chain engines
+    template<typename Engine>
+    inline Engine make_engine(boost::uint64_t i)
+    {
+        Engine e;
+        seed_engine(e, stream_seed(master_seed(), i));
+        return e;
+    }
+
+    /**
+     * Engine of the calling thread : threads use the streams 0,1,2... of the master seed, in the order of their first call.
+     * A single threaded program is thus reproducible once seeded, the engine of each thread should not be shared.
+     */
+    inline generator &random()
+    {
+        internal::engine_registry& r = internal::registry();
+        boost::thread_specific_ptr<internal::thread_engine>& p = internal::thread_engines();
+        internal::thread_engine *t = p.get();
+        // fast path : the engine of the thread is seeded from the current master seed
+        if(t && t->generation==r.generation.load(boost::memory_order_acquire)) return t->engine;
+
+        boost::mutex::scoped_lock lock(r.mutex);
+        if(!t) p.reset(t = new internal::thread_engine);
+        seed_engine(t->engine, stream_seed(r.master, r.next_stream++));
+        t->generation = r.generation.load(boost::memory_order_relaxed);
+        return t->engine;
     }
 
 }; // namespace rjmcmc
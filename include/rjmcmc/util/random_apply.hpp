@@ -38,6 +38,11 @@ knowledge of the CeCILL license and that you accept its terms.
 #define RANDOM_APPLY_HPP
 
 #include "tuple.hpp"
+#include <boost/preprocessor/repetition/repeat.hpp>
+
+#ifndef RJMCMC_RANDOM_APPLY_LIMIT_CASES
+#  define RJMCMC_RANDOM_APPLY_LIMIT_CASES 16
+#endif // RJMCMC_RANDOM_APPLY_LIMIT_CASES
 
 namespace rjmcmc {
 
@@ -93,6 +98,98 @@ namespace rjmcmc {
         return detail::random_apply_impl<0,tuple_size<T>::value>()(i,x*normalisation,t,f);
     }
 
+    namespace detail {
+
+        // application of f to the I-th element of t, if I<N
+        template <unsigned int I, bool Valid> struct random_apply_case
+        {
+            template <typename T, typename F>
+                    static inline typename F::result_type apply(double x, T& t, F &f) { return f(x,get<I>(t)); }
+        };
+
+        template <unsigned int I> struct random_apply_case<I,false>
+        {
+            template <typename T, typename F>
+                    static inline typename F::result_type apply(double x, T& t, F &f) { return typename F::result_type(); }
+        };
+
+        // indices beyond the cases of the switch
+        template <unsigned int I, unsigned int N> struct random_apply_index
+        {
+            template <typename T, typename F>
+                    inline typename F::result_type operator()(unsigned int i, double x, T& t, F &f) {
+                if(i==I) return f(x,get<I>(t));
+                return random_apply_index<I+1,N>()(i,x,t,f);
+            }
+        };
+
+        template <unsigned int N> struct random_apply_index<N,N>
+        {
+            template <typename T, typename F>
+                    inline typename F::result_type operator()(unsigned int i, double x, T& t, F &f) {
+                return typename F::result_type();
+            }
+        };
+
+        template <unsigned int I, unsigned int N> struct random_apply_probabilities
+        {
+            template <typename T>
+                    inline void operator()(const T& t, double *p) {
+                p[I] = get<I>(t).probability();
+                random_apply_probabilities<I+1,N>()(t,p);
+            }
+        };
+
+        template <unsigned int N> struct random_apply_probabilities<N,N>
+        {
+            template <typename T>
+                    inline void operator()(const T& t, double *p) {}
+        };
+    };
+
+/*
+ random_selector<T> is a random_apply that caches the probabilities of the elements of the tuple type T :
+ the element is selected by a loop over the cached probabilities, with the same arithmetic as random_apply,
+ and f is applied through a switch on its index.
+ update(t) must be called whenever the probabilities of the elements of t change.
+*/
+    template <typename T>
+    class random_selector
+    {
+        enum { N = tuple_size<T>::value };
+    public:
+        random_selector(const T& t) { update(t); }
+
+        void update(const T& t)
+        {
+            detail::random_apply_probabilities<0,N>()(t,m_probability);
+            m_normalisation = 0;
+            for(unsigned int i=N; i>0; --i) m_normalisation = m_probability[i-1]+m_normalisation;
+        }
+
+        inline double probability(unsigned int i) const { return m_probability[i]; }
+
+        template <typename F>
+                inline typename F::result_type operator()(unsigned int& i, double x, T& t, F &f) const {
+            double y = x*m_normalisation;
+            for(i=0; i<N; ++i) {
+                double z = y - m_probability[i];
+                if(!(z>0)) break;
+                y = z;
+            }
+#define RJMCMC_RANDOM_APPLY_CASE(z,n,_) case n : return detail::random_apply_case<n,(n<N)>::apply(y,t,f);
+            switch(i) {
+                BOOST_PP_REPEAT(RJMCMC_RANDOM_APPLY_LIMIT_CASES,RJMCMC_RANDOM_APPLY_CASE,_)
+            default : return detail::random_apply_index<(RJMCMC_RANDOM_APPLY_LIMIT_CASES<N ? RJMCMC_RANDOM_APPLY_LIMIT_CASES : N),N>()(i,y,t,f);
+            }
+#undef RJMCMC_RANDOM_APPLY_CASE
+        }
+
+    private:
+        double m_probability[N+1]; // N+1 avoids zero-sized arrays
+        double m_normalisation;
+    };
+
 }; // namespace rjmcmc
 
 #endif // RANDOM_APPLY_HPP
@@ -0,0 +1,170 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+#ifndef RANDOM_ENGINE_HPP
+#define RANDOM_ENGINE_HPP
+
+#include <boost/cstdint.hpp>
+#include <boost/config.hpp>
+
+namespace rjmcmc {
+
+    namespace internal {
+        inline boost::uint64_t rotl(boost::uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+    }; // namespace internal
+
+    // xoshiro256++ (Blackman and Vigna) : 256 bits of state, 64 bits outputs, period 2^256-1.
+    // jump() advances by 2^128 steps, which provides 2^128 non-overlapping streams.
+    // This is a model of the boost UniformRandomNumberGenerator concept.
+    class xoshiro256pp {
+    public:
+        typedef boost::uint64_t result_type;
+        BOOST_STATIC_CONSTANT(bool, has_fixed_range = false);
+
+        explicit xoshiro256pp(boost::uint64_t s = 0) { seed(s); }
+
+        // the state is filled by a splitmix64 sequence, as recommended by the authors
+        void seed(boost::uint64_t s)
+        {
+            for(int i=0; i<4; ++i)
+            {
+                boost::uint64_t z = (s += 0x9E3779B97F4A7C15ULL);
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+                m_s[i] = z ^ (z >> 31);
+            }
+        }
+        void seed(boost::uint64_t s0, boost::uint64_t s1, boost::uint64_t s2, boost::uint64_t s3)
+        {
+            m_s[0] = s0; m_s[1] = s1; m_s[2] = s2; m_s[3] = s3;
+        }
+
+        static result_type min BOOST_PREVENT_MACRO_SUBSTITUTION () { return 0; }
+        static result_type max BOOST_PREVENT_MACRO_SUBSTITUTION () { return ~result_type(0); }
+
+        inline result_type operator()()
+        {
+            const boost::uint64_t res = internal::rotl(m_s[0] + m_s[3], 23) + m_s[0];
+            const boost::uint64_t t = m_s[1] << 17;
+            m_s[2] ^= m_s[0];
+            m_s[3] ^= m_s[1];
+            m_s[1] ^= m_s[2];
+            m_s[0] ^= m_s[3];
+            m_s[2] ^= t;
+            m_s[3] = internal::rotl(m_s[3], 45);
+            return res;
+        }
+
+        void jump()
+        {
+            static const boost::uint64_t j[] = { 0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+            boost::uint64_t s[4] = { 0, 0, 0, 0 };
+            for(int i=0; i<4; ++i)
+                for(int b=0; b<64; ++b)
+                {
+                    if(j[i] & (boost::uint64_t(1) << b))
+                        for(int k=0; k<4; ++k) s[k] ^= m_s[k];
+                    (*this)();
+                }
+            for(int k=0; k<4; ++k) m_s[k] = s[k];
+        }
+
+        bool operator==(const xoshiro256pp& g) const { return m_s[0]==g.m_s[0] && m_s[1]==g.m_s[1] && m_s[2]==g.m_s[2] && m_s[3]==g.m_s[3]; }
+        bool operator!=(const xoshiro256pp& g) const { return !(*this==g); }
+
+    private:
+        boost::uint64_t m_s[4];
+    };
+
+    // pcg32 (O'Neill, XSH-RR variant) : 64 bits of state, 32 bits outputs, period 2^64.
+    // Each of the 2^63 values of 'stream' selects an independent sequence.
+    // This is a model of the boost UniformRandomNumberGenerator concept.
+    class pcg32 {
+    public:
+        typedef boost::uint32_t result_type;
+        BOOST_STATIC_CONSTANT(bool, has_fixed_range = false);
+
+        explicit pcg32(boost::uint64_t s = 0x853c49e6748fea9bULL, boost::uint64_t stream = 0xda3e39cb94b95bdbULL) { seed(s,stream); }
+
+        void seed(boost::uint64_t s, boost::uint64_t stream = 0xda3e39cb94b95bdbULL)
+        {
+            m_state = 0;
+            m_inc = (stream << 1) | 1;
+            (*this)();
+            m_state += s;
+            (*this)();
+        }
+
+        static result_type min BOOST_PREVENT_MACRO_SUBSTITUTION () { return 0; }
+        static result_type max BOOST_PREVENT_MACRO_SUBSTITUTION () { return ~result_type(0); }
+
+        inline result_type operator()()
+        {
+            boost::uint64_t old = m_state;
+            m_state = old * 6364136223846793005ULL + m_inc;
+            boost::uint32_t xorshifted = boost::uint32_t(((old >> 18) ^ old) >> 27);
+            boost::uint32_t rot = boost::uint32_t(old >> 59);
+            return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+        }
+
+        // advances by delta steps in O(log(delta))
+        void advance(boost::uint64_t delta)
+        {
+            boost::uint64_t mult = 6364136223846793005ULL, plus = m_inc;
+            boost::uint64_t acc_mult = 1, acc_plus = 0;
+            for(; delta; delta >>= 1)
+            {
+                if(delta & 1)
+                {
+                    acc_mult *= mult;
+                    acc_plus = acc_plus * mult + plus;
+                }
+                plus = (mult + 1) * plus;
+                mult *= mult;
+            }
+            m_state = acc_mult * m_state + acc_plus;
+        }
+
+        bool operator==(const pcg32& g) const { return m_state==g.m_state && m_inc==g.m_inc; }
+        bool operator!=(const pcg32& g) const { return !(*this==g); }
+
+    private:
+        boost::uint64_t m_state, m_inc;
+    };
+
+}; // namespace rjmcmc
+
+#endif // RANDOM_ENGINE_HPP
@@ -0,0 +1,107 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+// Synthetic benchmark of the neighbour accelerators of the configurations :
+// time per birth/death iteration as a function of the number of objects, at constant object density.
+// The rectangle sizes are drawn uniformly up to 'size', a large 'size' with a low density gives very uneven sizes.
+
+#include <ctime>
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+
+#include "synthetic_rectangles.hpp"
+
+// returns the time per iteration in microseconds, after a burn-in long enough to reach the expected object count
+template<typename Configuration>
+double run(Configuration& c, const workload& w, int iterations, unsigned int seed)
+{
+    rjmcmc::mt19937_generator e(seed);
+    sampler samp = w.make_sampler();
+    simulated_annealing::geometric_schedule<double> burnin_schedule(1.,1.), schedule(1.,1.);
+    simulated_annealing::max_iteration_end_test burnin_end(std::max(iterations,20*w.n)), end(iterations);
+    simulated_annealing::optimize(e,c,samp,burnin_schedule,burnin_end);
+    std::clock_t start = std::clock();
+    simulated_annealing::optimize(e,c,samp,schedule,end);
+    return 1e6*double(std::clock()-start)/CLOCKS_PER_SEC/iterations;
+}
+
+// the last column is the percentage of the candidate pairs reported by the accelerator that the interaction pipeline pruned
+template<typename Configuration>
+void report(const char *name, Configuration& c, double t)
+{
+    const marked_point_process::interaction_statistics& s = c.pruning_statistics();
+    double pruned = s.candidates ? 100.*(s.bbox_pruned+s.interact_pruned)/s.candidates : 0.;
+    std::cout << std::setw(10) << name << std::setw(10) << c.size() << std::setw(12) << t
+              << std::setw(16) << c.energy() << std::setw(8) << c.audit_structure() << std::setw(10) << pruned << std::endl;
+}
+
+int main(int argc , char** argv)
+{
+    int i=0;
+    int iterations  = (++i<argc) ? atoi(argv[i]) : 20000;
+    int nmax        = (++i<argc) ? atoi(argv[i]) : 10000;
+    double density  = (++i<argc) ? atof(argv[i]) : 0.01;
+    double size     = (++i<argc) ? atof(argv[i]) : 2.;
+    unsigned int seed = 1;
+
+    std::cout << std::setw(10) << "method" << std::setw(10) << "objects" << std::setw(12) << "us/iter"
+              << std::setw(16) << "energy" << std::setw(8) << "errors" << std::setw(10) << "pruned(%)" << std::endl;
+    for(int n=100; n<=nmax; n*=10)
+    {
+        workload w(n,density,size);
+        unary_energy e1(-1.);
+        binary_energy e2(10.,intersection_area_binary_energy<>());
+        trivial_configuration c0(e1,e2);
+        grid_configuration    c1(e1,e2,marked_point_process::grid_accelerator(0,0,w.side,w.side,4*size));
+        rtree_configuration   c2(e1,e2);
+        vector_rtree_configuration c3(e1,e2);
+        flat_grid_configuration c4(e1,e2,marked_point_process::grid_accelerator(0,0,w.side,w.side,4*size));
+        double t0 = run(c0,w,iterations,seed);
+        double t1 = run(c1,w,iterations,seed);
+        double t2 = run(c2,w,iterations,seed);
+        double t3 = run(c3,w,iterations,seed);
+        double t4 = run(c4,w,iterations,seed);
+        report("trivial",c0,t0);
+        report("grid"   ,c1,t1);
+        report("rtree"  ,c2,t2);
+        report("v-rtree",c3,t3);
+        report("f-grid" ,c4,t4);
+    }
+    return 0;
+}
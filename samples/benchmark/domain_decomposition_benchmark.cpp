@@ -0,0 +1,135 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+// Synthetic benchmark of the domain decomposition optimizer versus the single-threaded optimize loop :
+// both sample at a constant temperature for about the same number of proposals, and their throughputs are compared.
+// The 'merge' line runs the same phases with a single proposal per cell : its time is the cost of partitioning,
+// copying and merging the cells.
+
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+#include "synthetic_rectangles.hpp"
+#include "rjmcmc/simulated_annealing/domain_decomposition.hpp"
+
+typedef grid_configuration configuration;
+
+// the restriction of the poisson reference process to a cell : births restricted to the cell, with the poisson mean of the cell
+struct cell_sampler_factory {
+    typedef sampler result_type;
+    const workload& m_w;
+    mutable unsigned int m_calls;
+    cell_sampler_factory(const workload& w) : m_w(w), m_calls(0) {}
+    sampler operator()(const marked_point_process::bounding_box& c, unsigned int) const {
+        ++m_calls;
+        double size = m_w.size;
+        uniform_birth birth(Rectangle_2(Point_2(c.xmin,c.ymin),Vector_2(-size,-size),0.5),
+                            Rectangle_2(Point_2(c.xmax,c.ymax),Vector_2( size, size),1.));
+        double mean = double(m_w.n)*m_w.n*(c.xmax-c.xmin)*(c.ymax-c.ymin)/(m_w.side*m_w.side);
+        reference_process reference_pdf(distribution(mean), birth);
+        return sampler(reference_pdf, rjmcmc::metropolis_acceptance(),
+                       marked_point_process::make_uniform_birth_death_kernel(birth, 0.5, 0.5));
+    }
+};
+
+static double now()
+{
+    return (boost::posix_time::microsec_clock::universal_time()-boost::posix_time::ptime(boost::posix_time::min_date_time)).total_microseconds()*1e-6;
+}
+
+void report(const char *name, unsigned int threads, const configuration& c, double proposals, double time)
+{
+    std::cout << std::setw(10) << name << std::setw(10) << threads << std::setw(12) << proposals << std::setw(12) << time
+              << std::setw(12) << 1e6*time/proposals << std::setw(10) << c.size() << std::setw(16) << c.energy()
+              << std::setw(8) << c.audit_structure() << std::endl;
+}
+
+int main(int argc , char** argv)
+{
+    int i=0;
+    int iterations        = (++i<argc) ? atoi(argv[i]) : 2000000;
+    int n                 = (++i<argc) ? atoi(argv[i]) : 1000;
+    double cell_size      = (++i<argc) ? atof(argv[i]) : 32;
+    unsigned int per_cell = (++i<argc) ? atoi(argv[i]) : 1000;
+    unsigned int threads  = (++i<argc) ? atoi(argv[i]) : 0;
+    threads = rjmcmc::thread_count(threads);
+
+    workload w(n,0.01,2.);
+    unary_energy e1(-1.);
+    binary_energy e2(10.,intersection_area_binary_energy<>());
+    marked_point_process::bounding_box domain(0,0,w.side,w.side);
+    marked_point_process::grid_accelerator grid(0,0,w.side,w.side,4*w.size);
+    // number of phases for about 'iterations' proposals : a quarter of the cells is active at each phase
+    int cells = int(std::ceil(w.side/cell_size)+1);
+    int phases = std::max(1,int(4.*iterations/(double(per_cell)*cells*cells)));
+
+    std::cout << std::setw(10) << "method" << std::setw(10) << "threads" << std::setw(12) << "proposals" << std::setw(12) << "time(s)"
+              << std::setw(12) << "us/prop" << std::setw(10) << "objects" << std::setw(16) << "energy" << std::setw(8) << "errors" << std::endl;
+    {
+        configuration c(e1,e2,grid);
+        rjmcmc::mt19937_generator e(1);
+        sampler samp = w.make_sampler();
+        simulated_annealing::geometric_schedule<double> schedule(1.,1.);
+        simulated_annealing::max_iteration_end_test end(iterations);
+        double start = now();
+        simulated_annealing::optimize(e,c,samp,schedule,end);
+        report("optimize",1,c,iterations,now()-start);
+    }
+    unsigned int nthreads[2] = { 1, threads };
+    for(unsigned int k=0; k<2; ++k)
+    {
+        configuration c(e1,e2,grid);
+        rjmcmc::mt19937_generator e(1);
+        cell_sampler_factory factory(w);
+        simulated_annealing::geometric_schedule<double> schedule(1.,1.);
+        simulated_annealing::max_iteration_end_test end(phases);
+        double start = now();
+        simulated_annealing::domain_decomposition(e,c,factory,schedule,end,domain,cell_size,0.,per_cell,nthreads[k]);
+        double time = now()-start;
+        double proposals = double(factory.m_calls-1)*per_cell;
+        report("cells",nthreads[k],c,proposals,time);
+        if(k>0) continue;
+        // the same number of phases from the configuration reached, with a single proposal per cell,
+        // reported per proposal of the line above to compare with the time per proposal of optimize
+        simulated_annealing::max_iteration_end_test merge_end(phases);
+        start = now();
+        simulated_annealing::domain_decomposition(e,c,factory,schedule,merge_end,domain,cell_size,0.,1,1);
+        report("merge",1,c,proposals,now()-start);
+    }
+    return 0;
+}
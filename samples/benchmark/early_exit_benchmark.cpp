@@ -0,0 +1,91 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+// Synthetic benchmark of the early exit of the energy variation : the same annealing with the metropolis acceptance
+// and with the early_exit_metropolis_acceptance, which draws the uniform variate first and lets the configuration stop
+// the evaluation of the binary energies of rejected proposals. Large rectangles at low temperature favour the early exits.
+
+#include <ctime>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+
+#include "synthetic_rectangles.hpp"
+
+typedef rjmcmc::sampler<reference_process,rjmcmc::early_exit_metropolis_acceptance,birth_death_kernel> early_exit_sampler;
+
+template<typename Sampler>
+void run(const char *name, const Sampler& s, const workload& w, double temp, int iterations, unsigned int seed)
+{
+    unary_energy e1(-1.);
+    binary_energy e2(10.,intersection_area_binary_energy<>());
+    flat_grid_configuration c(e1,e2,marked_point_process::grid_accelerator(0,0,w.side,w.side,4*w.size));
+    Sampler samp(s);
+    rjmcmc::mt19937_generator e(seed);
+    simulated_annealing::geometric_schedule<double> schedule(temp,1.);
+    simulated_annealing::max_iteration_end_test burnin_end(20*w.n), end(iterations);
+    simulated_annealing::optimize(e,c,samp,schedule,burnin_end);
+    unsigned long evaluations = c.binary_evaluations();
+    std::clock_t start = std::clock();
+    simulated_annealing::optimize(e,c,samp,schedule,end);
+    double t = 1e6*double(std::clock()-start)/CLOCKS_PER_SEC/iterations;
+    std::cout << std::setw(12) << name << std::setw(10) << c.size() << std::setw(12) << t
+              << std::setw(16) << c.energy() << std::setw(14) << double(c.binary_evaluations()-evaluations)/iterations << std::endl;
+}
+
+int main(int argc , char** argv)
+{
+    int i=0;
+    int iterations  = (++i<argc) ? atoi(argv[i]) : 200000;
+    int n           = (++i<argc) ? atoi(argv[i]) : 1000;
+    double density  = (++i<argc) ? atof(argv[i]) : 0.01;
+    double size     = (++i<argc) ? atof(argv[i]) : 10.;
+    double temp     = (++i<argc) ? atof(argv[i]) : 0.1;
+    unsigned int seed = 1;
+
+    workload w(n,density,size);
+    uniform_birth b = w.birth();
+    reference_process reference_pdf(distribution(double(n)*n), b);
+    sampler s0 = w.make_sampler();
+    early_exit_sampler s1(reference_pdf, rjmcmc::early_exit_metropolis_acceptance(),
+                          marked_point_process::make_uniform_birth_death_kernel(b, 0.5, 0.5));
+
+    std::cout << std::setw(12) << "acceptance" << std::setw(10) << "objects" << std::setw(12) << "us/iter"
+              << std::setw(16) << "energy" << std::setw(14) << "evals/iter" << std::endl;
+    run("metropolis",s0,w,temp,iterations,seed);
+    run("early-exit",s1,w,temp,iterations,seed);
+    return 0;
+}
@@ -0,0 +1,107 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+// Microbenchmark of the integrated flux of rectangles on a random gradient image :
+// time per rectangle of the scalar and batched kernels, as a function of the rectangle size.
+
+#include <ctime>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+
+#include "rjmcmc/geometry/geometry.hpp"
+#include "rjmcmc/geometry/Rectangle_2.hpp"
+#include "rjmcmc/geometry/integrated_flux/batched_integrated_flux.hpp"
+#include "rjmcmc/image/gradient_functor.hpp"
+#include "rjmcmc/image/oriented.hpp"
+
+typedef geometry::Simple_cartesian<double> K;
+typedef geometry::Rectangle_2<K> Rectangle_2;
+typedef oriented<gradient_image_t> oriented_gradient_image;
+
+static double uniform(double a, double b) { return a+(b-a)*std::rand()/RAND_MAX; }
+
+// returns the time per rectangle in nanoseconds, and the sum of the fluxes in res
+template<typename F>
+double run(F f, const oriented_gradient_image& img, const std::vector<Rectangle_2>& r, int repeat, double& res)
+{
+    res = 0;
+    std::clock_t start = std::clock();
+    for(int k=0; k<repeat; ++k)
+        for(std::vector<Rectangle_2>::const_iterator it=r.begin(); it!=r.end(); ++it)
+            res += f(img,*it);
+    return 1e9*double(std::clock()-start)/CLOCKS_PER_SEC/(repeat*r.size());
+}
+
+double scalar (const oriented_gradient_image& img, const Rectangle_2& r) { return integrated_flux(img,r); }
+double batched(const oriented_gradient_image& img, const Rectangle_2& r) { return batched_integrated_flux(img,r); }
+
+int main(int argc , char** argv)
+{
+    int i=0;
+    int repeat = (++i<argc) ? atoi(argv[i]) : 100;
+    int side   = (++i<argc) ? atoi(argv[i]) : 1024;
+
+    boost::shared_ptr<gradient_image_t> img(new gradient_image_t(side,side));
+    gradient_view_t v = boost::gil::view(*img);
+    for(int y=0; y<side; ++y)
+        for(int x=0; x<side; ++x) {
+            boost::gil::at_c<0>(v(x,y)) = float(uniform(-1,1));
+            boost::gil::at_c<1>(v(x,y)) = float(uniform(-1,1));
+        }
+    oriented_gradient_image grad(img,v);
+
+    std::cout << std::setw(8) << "size" << std::setw(12) << "scalar ns" << std::setw(12) << "batched ns"
+              << std::setw(10) << "speedup" << std::setw(14) << "rel. error" << std::endl;
+    for(int size=10; size<=60; size+=10)
+    {
+        // rectangles with a random orientation, a long side of 'size' pixels and a ratio in [0.3,1]
+        std::vector<Rectangle_2> r;
+        for(int k=0; k<1000; ++k) {
+            double a = uniform(0,2*M_PI);
+            K::Point_2 c(uniform(size,side-size),uniform(size,side-size));
+            r.push_back(Rectangle_2(c,K::Vector_2(0.5*size*std::cos(a),0.5*size*std::sin(a)),uniform(0.3,1)));
+        }
+        double res0, res1;
+        double t0 = run(scalar ,grad,r,repeat,res0);
+        double t1 = run(batched,grad,r,repeat,res1);
+        std::cout << std::setw(8) << size << std::setw(12) << t0 << std::setw(12) << t1
+                  << std::setw(10) << t0/t1 << std::setw(14) << std::abs(res1-res0)/std::abs(res0) << std::endl;
+    }
+    return 0;
+}
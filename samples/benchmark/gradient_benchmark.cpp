@@ -0,0 +1,96 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+// Start-up benchmark of the gradient computation on a synthetic elevation image :
+// time of gradient_functor and of parallel_gradient_functor, and the largest difference between their outputs.
+
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+#include "rjmcmc/image/gradient_functor_inc.hpp"
+#include "rjmcmc/image/parallel_gradient_functor_inc.hpp"
+
+typedef boost::gil::gray16_image_t dsm_image_t;
+
+// wall clock time in seconds of f(g,v)
+template<typename F>
+double run(const F& f, gradient_image_t& g, const dsm_image_t::const_view_t& v)
+{
+    boost::posix_time::ptime start = boost::posix_time::microsec_clock::local_time();
+    f(g,v);
+    return 1e-6*(boost::posix_time::microsec_clock::local_time()-start).total_microseconds();
+}
+
+float max_difference(const gradient_image_t& a, const gradient_image_t& b)
+{
+    gradient_image_t::const_view_t va = boost::gil::const_view(a), vb = boost::gil::const_view(b);
+    float d = 0;
+    for(int j=0; j<va.height(); ++j)
+        for(int i=0; i<va.width(); ++i)
+            for(int c=0; c<2; ++c)
+                d = std::max(d,std::abs(va(i,j)[c]-vb(i,j)[c]));
+    return d;
+}
+
+int main(int argc , char** argv)
+{
+    int i=0;
+    int side     = (++i<argc) ? atoi(argv[i]) : 4000;
+    double sigma = (++i<argc) ? atof(argv[i]) : 1.;
+    unsigned int nthreads = (++i<argc) ? atoi(argv[i]) : 0;
+
+    // blocky synthetic elevations with noise
+    dsm_image_t dsm(side,side);
+    dsm_image_t::view_t v = boost::gil::view(dsm);
+    for(int y=0; y<side; ++y)
+        for(int x=0; x<side; ++x)
+            v(x,y) = (unsigned short) (1000*(((x/37)^(y/53))&1) + std::rand()%50);
+
+    gradient_image_t g0, g1, gn;
+    double t0 = run(gradient_functor(sigma),g0,boost::gil::const_view(dsm));
+    double t1 = run(parallel_gradient_functor(sigma,1),g1,boost::gil::const_view(dsm));
+    double tn = run(parallel_gradient_functor(sigma,nthreads),gn,boost::gil::const_view(dsm));
+
+    std::cout << std::setw(30) << "method" << std::setw(12) << "seconds" << std::setw(14) << "max. diff" << std::endl;
+    std::cout << std::setw(30) << "gradient_functor" << std::setw(12) << t0 << std::setw(14) << 0 << std::endl;
+    std::cout << std::setw(30) << "parallel_gradient_functor(1)" << std::setw(12) << t1 << std::setw(14) << max_difference(g0,g1) << std::endl;
+    std::cout << std::setw(27) << "parallel_gradient_functor(" << std::setw(2) << rjmcmc::thread_count(nthreads) << ")"
+              << std::setw(12) << tn << std::setw(14) << max_difference(g0,gn) << std::endl;
+    return 0;
+}
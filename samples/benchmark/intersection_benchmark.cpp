@@ -0,0 +1,103 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+// Microbenchmark of the intersection area of a rectangle with its neighbour candidates :
+// time per pair of intersection_area and of its batched version.
+
+#include <ctime>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+
+#include "rjmcmc/geometry/geometry.hpp"
+#include "rjmcmc/geometry/Rectangle_2.hpp"
+#include "rjmcmc/geometry/intersection/Rectangle_2_intersection.hpp"
+#include "rjmcmc/geometry/intersection/Rectangle_2_batch_intersection.hpp"
+
+typedef geometry::Simple_cartesian<double> K;
+typedef geometry::Rectangle_2<K> Rectangle_2;
+
+static double uniform(double a, double b) { return a+(b-a)*std::rand()/RAND_MAX; }
+
+static Rectangle_2 random_rectangle(double side)
+{
+    double a = uniform(0,2*M_PI), l = uniform(1,10);
+    return Rectangle_2(K::Point_2(uniform(0,side),uniform(0,side)),K::Vector_2(l*std::cos(a),l*std::sin(a)),uniform(0.3,1));
+}
+
+int main(int argc , char** argv)
+{
+    int i=0;
+    int repeat     = (++i<argc) ? atoi(argv[i]) : 200;
+    int candidates = (++i<argc) ? atoi(argv[i]) : 16;
+
+    std::cout << std::setw(8) << "side" << std::setw(10) << "hits" << std::setw(12) << "area ns"
+              << std::setw(12) << "batch ns" << std::endl;
+    // the side of the square of the candidates controls the proportion of intersecting pairs
+    for(double side=10; side<=80; side*=2)
+    {
+        std::vector<Rectangle_2> a, b;
+        for(int k=0; k<1000; ++k) a.push_back(random_rectangle(side));
+        for(int k=0; k<1000*candidates; ++k) b.push_back(random_rectangle(side));
+        std::vector<double> area(candidates);
+        double res0 = 0, res1 = 0;
+        int hits = 0;
+
+        std::clock_t start = std::clock();
+        for(int r=0; r<repeat; ++r)
+            for(int k=0; k<1000; ++k)
+                for(int j=0; j<candidates; ++j)
+                    res0 += std::abs(geometry::intersection_area(a[k],b[k*candidates+j]));
+        double t0 = double(std::clock()-start);
+
+        start = std::clock();
+        for(int r=0; r<repeat; ++r)
+            for(int k=0; k<1000; ++k) {
+                geometry::intersection_areas(a[k],&b[k*candidates],candidates,&area[0]);
+                for(int j=0; j<candidates; ++j) { res1 += area[j]; hits += (r==0 && area[j]>0); }
+            }
+        double t1 = double(std::clock()-start);
+
+        double scale = 1e9/CLOCKS_PER_SEC/(double(repeat)*1000*candidates);
+        std::cout << std::setw(8) << side << std::setw(10) << double(hits)/(1000*candidates)
+                  << std::setw(12) << t0*scale << std::setw(12) << t1*scale;
+        if(std::abs(res1-res0)>1e-9*res0) std::cout << "  (areas differ)";
+        std::cout << std::endl;
+    }
+    return 0;
+}
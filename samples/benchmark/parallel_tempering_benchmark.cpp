@@ -0,0 +1,96 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+// Synthetic benchmark of the replica exchange optimizer :
+// wall-clock time of a fixed number of rounds with one thread and with 'threads' threads,
+// and final energy compared to a single chain annealed with the same schedule.
+
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+#include "synthetic_rectangles.hpp"
+#include "rjmcmc/simulated_annealing/parallel_tempering.hpp"
+
+typedef flat_grid_configuration configuration;
+
+static double now()
+{
+    return (boost::posix_time::microsec_clock::universal_time()-boost::posix_time::ptime(boost::posix_time::min_date_time)).total_microseconds()*1e-6;
+}
+
+// returns the wall-clock time in seconds, replicas=0 runs a single chain with optimize
+double run(configuration& c, const workload& w, int iterations, unsigned int replicas, unsigned int threads, unsigned int interval)
+{
+    rjmcmc::mt19937_generator e(1);
+    sampler samp = w.make_sampler();
+    simulated_annealing::geometric_schedule<double> schedule(10.,std::pow(1e-3,1./iterations));
+    simulated_annealing::max_iteration_end_test end(iterations);
+    double start = now();
+    if(replicas==0)
+        simulated_annealing::optimize(e,c,samp,schedule,end);
+    else
+        simulated_annealing::parallel_tempering(e,c,samp,schedule,end,simulated_annealing::geometric_ladder(replicas,1.5),interval,threads);
+    return now()-start;
+}
+
+int main(int argc , char** argv)
+{
+    int i=0;
+    int iterations        = (++i<argc) ? atoi(argv[i]) : 200000;
+    unsigned int replicas = (++i<argc) ? atoi(argv[i]) : 8;
+    unsigned int threads  = (++i<argc) ? atoi(argv[i]) : 0;
+    int n                 = (++i<argc) ? atoi(argv[i]) : 1000;
+    unsigned int interval = (++i<argc) ? atoi(argv[i]) : 1000;
+    threads = rjmcmc::thread_count(threads);
+
+    workload w(n,0.01,2.);
+    unary_energy e1(-1.);
+    binary_energy e2(10.,intersection_area_binary_energy<>());
+    marked_point_process::grid_accelerator grid(0,0,w.side,w.side,4*w.size);
+
+    std::cout << std::setw(10) << "replicas" << std::setw(10) << "threads" << std::setw(12) << "time(s)"
+              << std::setw(12) << "speedup" << std::setw(10) << "objects" << std::setw(16) << "energy" << std::endl;
+    configuration c0(e1,e2,grid), c1(e1,e2,grid), c2(e1,e2,grid);
+    double t0 = run(c0,w,iterations,0,1,interval);
+    double t1 = run(c1,w,iterations,replicas,1,interval);
+    double t2 = run(c2,w,iterations,replicas,threads,interval);
+    std::cout << std::setw(10) << 1        << std::setw(10) << 1       << std::setw(12) << t0 << std::setw(12) << "-"   << std::setw(10) << c0.size() << std::setw(16) << c0.energy() << std::endl;
+    std::cout << std::setw(10) << replicas << std::setw(10) << 1       << std::setw(12) << t1 << std::setw(12) << 1.    << std::setw(10) << c1.size() << std::setw(16) << c1.energy() << std::endl;
+    std::cout << std::setw(10) << replicas << std::setw(10) << threads << std::setw(12) << t2 << std::setw(12) << t1/t2 << std::setw(10) << c2.size() << std::setw(16) << c2.energy() << std::endl;
+    return 0;
+}
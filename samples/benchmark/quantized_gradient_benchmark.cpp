@@ -0,0 +1,127 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+// Benchmark of the quantized (2 x int16) gradient image versus the float32 one :
+// memory footprint, time per integrated flux of rectangles and circles, and flux error versus its bound.
+
+#include <ctime>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+
+#include "rjmcmc/geometry/geometry.hpp"
+#include "rjmcmc/geometry/Rectangle_2.hpp"
+#include "rjmcmc/geometry/Circle_2.hpp"
+#include "rjmcmc/geometry/integrated_flux/Rectangle_2_integrated_flux.hpp"
+#include "rjmcmc/geometry/integrated_flux/Circle_2_integrated_flux.hpp"
+#include "rjmcmc/image/gradient_functor.hpp"
+#include "rjmcmc/image/oriented.hpp"
+#include "rjmcmc/image/quantized_gradient.hpp"
+
+typedef geometry::Simple_cartesian<double> K;
+typedef geometry::Rectangle_2<K> Rectangle_2;
+typedef geometry::Circle_2<K> Circle_2;
+typedef oriented<gradient_image_t> oriented_gradient_image;
+
+static double uniform(double a, double b) { return a+(b-a)*std::rand()/RAND_MAX; }
+static double perimeter(const Rectangle_2& r) { return std::sqrt(r.squared_perimeter()); }
+static double perimeter(const Circle_2& c) { return geometry::perimeter(c); }
+
+// returns the time per object in nanoseconds, and the fluxes in res
+template<typename OrientedImage, typename Object>
+double run(const OrientedImage& img, const std::vector<Object>& o, int repeat, std::vector<double>& res)
+{
+    res.assign(o.size(),0.);
+    std::clock_t start = std::clock();
+    for(int k=0; k<repeat; ++k)
+        for(std::size_t i=0; i<o.size(); ++i)
+            res[i] = integrated_flux(img,o[i]);
+    return 1e9*double(std::clock()-start)/CLOCKS_PER_SEC/(repeat*o.size());
+}
+
+// prints the timings, and the largest ratio of the flux error to its bound
+template<typename Object>
+void compare(const char *name, const oriented_gradient_image& grad, const quantized_gradient& quant,
+             const std::vector<Object>& o, int repeat)
+{
+    std::vector<double> res0, res1;
+    double t0 = run(grad ,o,repeat,res0);
+    double t1 = run(quant,o,repeat,res1);
+    double ratio = 0;
+    for(std::size_t i=0; i<o.size(); ++i)
+        ratio = std::max(ratio,std::abs(res1[i]-res0[i])/quant.max_error(perimeter(o[i])));
+    std::cout << std::setw(10) << name << std::setw(12) << t0 << std::setw(12) << t1
+              << std::setw(10) << t0/t1 << std::setw(16) << ratio << std::endl;
+}
+
+int main(int argc , char** argv)
+{
+    int i=0;
+    int repeat = (++i<argc) ? atoi(argv[i]) : 100;
+    int side   = (++i<argc) ? atoi(argv[i]) : 4096;
+    int size   = (++i<argc) ? atoi(argv[i]) : 40;
+
+    boost::shared_ptr<gradient_image_t> img(new gradient_image_t(side,side));
+    gradient_view_t v = boost::gil::view(*img);
+    for(int y=0; y<side; ++y)
+        for(int x=0; x<side; ++x) {
+            boost::gil::at_c<0>(v(x,y)) = float(uniform(-10,10));
+            boost::gil::at_c<1>(v(x,y)) = float(uniform(-10,10));
+        }
+    oriented_gradient_image grad(img,v);
+    quantized_gradient quant(grad);
+
+    std::cout << "image " << side << "x" << side << " : float32 " << (sizeof(gradient_image_t::value_type)*side*side>>20)
+              << " MB, int16 " << (sizeof(quantized_gradient_image_t::value_type)*side*side>>20)
+              << " MB, scale " << quant.scale() << std::endl;
+
+    // objects spread over the whole image, so that the flux evaluations are bound by memory accesses
+    std::vector<Rectangle_2> r;
+    std::vector<Circle_2> c;
+    for(int k=0; k<10000; ++k) {
+        double a = uniform(0,2*M_PI);
+        K::Point_2 p(uniform(size,side-size),uniform(size,side-size));
+        r.push_back(Rectangle_2(p,K::Vector_2(0.5*size*std::cos(a),0.5*size*std::sin(a)),uniform(0.3,1)));
+        c.push_back(Circle_2(p,uniform(0.25*size,0.5*size)));
+    }
+    std::cout << std::setw(10) << "object" << std::setw(12) << "float32 ns" << std::setw(12) << "int16 ns"
+              << std::setw(10) << "speedup" << std::setw(16) << "error/bound" << std::endl;
+    compare("rectangle",grad,quant,r,repeat);
+    compare("circle"   ,grad,quant,c,repeat);
+    return 0;
+}
@@ -0,0 +1,107 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+#ifndef SYNTHETIC_RECTANGLES_HPP
+#define SYNTHETIC_RECTANGLES_HPP
+
+// Synthetic rectangle model shared by the benchmarks : constant unary energy and penalized overlaps.
+
+#include <cmath>
+
+#include "rjmcmc/util/random.hpp"
+
+#include "rjmcmc/geometry/geometry.hpp"
+#include "rjmcmc/geometry/Rectangle_2.hpp"
+#include "rjmcmc/geometry/intersection/Rectangle_2_intersection.hpp"
+#include "rjmcmc/geometry/coordinates/Rectangle_2_coordinates.hpp"
+typedef geometry::Simple_cartesian<double> K;
+typedef K::Point_2 Point_2;
+typedef K::Vector_2 Vector_2;
+typedef geometry::Rectangle_2<K> Rectangle_2;
+typedef Rectangle_2 object;
+
+#include "rjmcmc/rjmcmc/energy/constant_energy.hpp"
+#include "rjmcmc/rjmcmc/energy/energy_operators.hpp"
+#include "rjmcmc/mpp/energy/intersection_area_binary_energy.hpp"
+typedef constant_energy<> unary_energy;
+typedef multiplies_energy<constant_energy<>,intersection_area_binary_energy<> > binary_energy;
+
+#include "rjmcmc/mpp/configuration/graph_configuration.hpp"
+#include "rjmcmc/mpp/configuration/vector_configuration.hpp"
+#include "rjmcmc/mpp/configuration/flat_graph_configuration.hpp"
+#include "rjmcmc/mpp/configuration/grid_accelerator.hpp"
+#include "rjmcmc/mpp/configuration/rtree_accelerator.hpp"
+typedef marked_point_process::graph_configuration<object, unary_energy, binary_energy> trivial_configuration;
+typedef marked_point_process::graph_configuration<object, unary_energy, binary_energy, marked_point_process::grid_accelerator> grid_configuration;
+typedef marked_point_process::graph_configuration<object, unary_energy, binary_energy, marked_point_process::rtree_accelerator> rtree_configuration;
+typedef marked_point_process::vector_configuration<object, unary_energy, binary_energy, marked_point_process::rtree_accelerator> vector_rtree_configuration;
+typedef marked_point_process::flat_graph_configuration<object, unary_energy, binary_energy, marked_point_process::grid_accelerator> flat_grid_configuration;
+
+#include "rjmcmc/rjmcmc/distribution/poisson_distribution.hpp"
+#include "rjmcmc/mpp/kernel/uniform_birth.hpp"
+#include "rjmcmc/mpp/direct_sampler.hpp"
+#include "rjmcmc/rjmcmc/acceptance/metropolis_acceptance.hpp"
+#include "rjmcmc/rjmcmc/sampler/sampler.hpp"
+#include "rjmcmc/mpp/kernel/uniform_birth_death_kernel.hpp"
+typedef rjmcmc::poisson_distribution distribution;
+typedef marked_point_process::uniform_birth<object> uniform_birth;
+typedef marked_point_process::direct_sampler<distribution,uniform_birth> reference_process;
+typedef marked_point_process::uniform_birth_death_kernel<uniform_birth>::type birth_death_kernel;
+typedef rjmcmc::sampler<reference_process,rjmcmc::metropolis_acceptance,birth_death_kernel> sampler;
+
+#include "rjmcmc/simulated_annealing/schedule/geometric_schedule.hpp"
+#include "rjmcmc/simulated_annealing/end_test/max_iteration_end_test.hpp"
+#include "rjmcmc/simulated_annealing/simulated_annealing.hpp"
+
+// rectangles of half-size up to 'size' in a square of side 'side', with an expected count of n objects
+struct workload {
+    double side, size;
+    int n;
+    workload(int n_, double density, double size_) : side(std::sqrt(n_/density)), size(size_), n(n_) {}
+    uniform_birth birth() const {
+        return uniform_birth(Rectangle_2(Point_2(0,0),Vector_2(-size,-size),0.5),
+                             Rectangle_2(Point_2(side,side),Vector_2(size,size),1.));
+    }
+    // birth/death sampler : the equilibrium size of this chain grows as the square root of the poisson mean
+    sampler make_sampler() const {
+        uniform_birth b = birth();
+        reference_process reference_pdf(distribution(double(n)*n), b);
+        return sampler(reference_pdf, rjmcmc::metropolis_acceptance(),
+                       marked_point_process::make_uniform_birth_death_kernel(b, 0.5, 0.5));
+    }
+};
+
+#endif // SYNTHETIC_RECTANGLES_HPP
@@ -0,0 +1,133 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+// Compares the neighbour accelerators of the configurations on the building_footprint_rectangle workload
+// (by default samples/data/ZTerrain_c3.tif), using the same parameters as the CLI sample, e.g. :
+// building_footprint_rectangle_benchmark -I 200000
+
+#include <ctime>
+#include <iostream>
+#include <iomanip>
+
+#include "rjmcmc/param/parameter.hpp"
+typedef parameters< parameter > param;
+#include "building_footprint_rectangle_parameters_inc.hpp"
+#include "building_footprint_rectangle.hpp"
+
+#include "rjmcmc/mpp/configuration/vector_configuration.hpp"
+#include "rjmcmc/mpp/configuration/flat_graph_configuration.hpp"
+#include "rjmcmc/mpp/configuration/rtree_accelerator.hpp"
+using marked_point_process::graph_configuration;
+using marked_point_process::vector_configuration;
+using marked_point_process::flat_graph_configuration;
+using marked_point_process::trivial_accelerator;
+using marked_point_process::grid_accelerator;
+using marked_point_process::rtree_accelerator;
+
+template<typename Configuration>
+void run(const char *name, const param *p, Configuration& c)
+{
+    sampler  *samp; create_sampler (p,samp);
+    schedule *sch ; create_schedule(p,sch);
+    end_test *end ; create_end_test(p,end);
+    rjmcmc::mt19937_generator e(1);
+
+    std::clock_t start = std::clock();
+    int iterations = simulated_annealing::optimize(e,c,*samp,*sch,*end);
+    double t = 1e6*double(std::clock()-start)/CLOCKS_PER_SEC/iterations;
+
+    std::cout << std::setw(16) << name << std::setw(10) << c.size() << std::setw(12) << t
+              << std::setw(16) << c.energy() << std::setw(16) << c.audit_unary_energy()+c.audit_binary_energy() << std::endl;
+    delete samp;
+    delete sch;
+    delete end;
+}
+
+int main(int argc , char** argv)
+{
+    param *p = new param;
+    initialize_parameters(p);
+    if (!p->parse(argc, argv)) return -1;
+
+    Iso_rectangle_2 bbox = get_bbox(p);
+    std::string  dsm_file = p->get<boost::filesystem::path>("dsm").string();
+    clip_bbox(bbox, dsm_file);
+    gradient_functor gf(p->get<double>("sigmaD"));
+    oriented_gradient_image grad_image(dsm_file, bbox, gf);
+    set_bbox(p,bbox);
+
+    weighted_unary_energy  e1(p->get<double>("energy")-(p->get<double>("ponderation_grad")*unary_energy(grad_image)));
+    weighted_binary_energy e2(p->get<double>("ponderation_surface")*binary_energy());
+    double cell = 2*p->get<double>("maxsize");
+    grid_accelerator grid(bbox.min().x(),bbox.min().y(),bbox.max().x(),bbox.max().y(),cell);
+
+    std::cout << std::setw(16) << "configuration" << std::setw(10) << "objects" << std::setw(12) << "us/iter"
+              << std::setw(16) << "energy" << std::setw(16) << "audit" << std::endl;
+    {
+        graph_configuration<object,weighted_unary_energy,weighted_binary_energy,trivial_accelerator> c(e1,e2);
+        run("graph/trivial",p,c);
+    }
+    {
+        graph_configuration<object,weighted_unary_energy,weighted_binary_energy,grid_accelerator> c(e1,e2,grid);
+        run("graph/grid",p,c);
+    }
+    {
+        graph_configuration<object,weighted_unary_energy,weighted_binary_energy,rtree_accelerator> c(e1,e2);
+        run("graph/rtree",p,c);
+    }
+    {
+        flat_graph_configuration<object,weighted_unary_energy,weighted_binary_energy,grid_accelerator> c(e1,e2,grid);
+        run("flat/grid",p,c);
+    }
+    {
+        flat_graph_configuration<object,weighted_unary_energy,weighted_binary_energy,rtree_accelerator> c(e1,e2);
+        run("flat/rtree",p,c);
+    }
+    {
+        vector_configuration<object,weighted_unary_energy,weighted_binary_energy,trivial_accelerator> c(e1,e2);
+        run("vector/trivial",p,c);
+    }
+    {
+        vector_configuration<object,weighted_unary_energy,weighted_binary_energy,grid_accelerator> c(e1,e2,grid);
+        run("vector/grid",p,c);
+    }
+    {
+        vector_configuration<object,weighted_unary_energy,weighted_binary_energy,rtree_accelerator> c(e1,e2);
+        run("vector/rtree",p,c);
+    }
+    delete p;
+    return 0;
+}
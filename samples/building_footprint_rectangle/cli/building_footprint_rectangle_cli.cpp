@@ -46,13 +46,28 @@ typedef parameters< parameter > param;
 
 //[building_footprint_rectangle_cli_visitors
 #include "rjmcmc/rjmcmc/sampler/any_sampler.hpp"
+#include "rjmcmc/rjmcmc/sampler/adaptive_sampler.hpp"
 #include "rjmcmc/simulated_annealing/visitor/any_visitor.hpp"
 #include "rjmcmc/simulated_annealing/visitor/ostream_visitor.hpp"
+#include "rjmcmc/simulated_annealing/parallel_tempering.hpp"
+#include "rjmcmc/simulated_annealing/multi_start.hpp"
 #ifdef USE_SHP
 # include "rjmcmc/simulated_annealing/visitor/shp_visitor.hpp"
 #endif
 //]
 
+// prints the tuned kernel probabilities as command line options
+template<typename Adaptive> void report_tuned(const Adaptive& adaptive)
+{
+    adaptive.report(std::cout);
+    double p_edge = 0, p_corner = 0;
+    for(unsigned int i=2; i<6 ; ++i) p_edge   += adaptive.tuned_probability(i);
+    for(unsigned int i=6; i<10; ++i) p_corner += adaptive.tuned_probability(i);
+    std::cout << "Tuned parameters : --p_birthdeath " << adaptive.tuned_probability(0)
+              << " --p_split_merge " << adaptive.tuned_probability(1)
+              << " --p_edge " << p_edge << " --p_corner " << p_corner << std::endl;
+}
+
 //[building_footprint_rectangle_cli_main
 int main(int argc , char** argv)
 {
@@ -60,6 +75,7 @@ int main(int argc , char** argv)
     param *p = new param;
     initialize_parameters(p);
     if (!p->parse(argc, argv)) return -1;
+    if (p->get<int>("seed")>=0) rjmcmc::seed(p->get<int>("seed"));
 
 
     /*< Input data is an image. We first retrieve from the parameters the region to process... clip the image to fit this region... and then compute the gradient and build the attached view>*/
@@ -67,8 +83,8 @@ int main(int argc , char** argv)
     std::string  dsm_file = p->get<boost::filesystem::path>("dsm").string();
     clip_bbox(bbox, dsm_file);
 
-    gradient_functor gf(p->get<double>("sigmaD"));
-    oriented_gradient_image grad_image(dsm_file, bbox, gf);
+    parallel_gradient_functor gf(p->get<double>("sigmaD"),p->get<int>("threads"));
+    oriented_gradient_image grad_image = cached_gradient(dsm_file, bbox, gf, p->get<boost::filesystem::path>("gradient_cache").string());
 
     set_bbox(p,bbox);
 
@@ -79,10 +95,18 @@ int main(int argc , char** argv)
     end_test      *end ; create_end_test     (p,end);
 
     // test avec les any_*
-    typedef rjmcmc::mt19937_generator Engine;
+    typedef rjmcmc::generator Engine;
     Engine& e = rjmcmc::random();
     typedef rjmcmc::any_sampler<Engine,configuration> any_sampler;
-    any_sampler sampler(*samp);
+    /*< The kernel probabilities may be tuned during a burn-in of a single chain, they are frozen afterwards.
+        The cost of the proposals is their number of energy evaluations, which keeps seeded runs reproducible, or their CPU time >*/
+    int replicas = p->get<int>("replicas");
+    int starts   = p->get<int>("starts");
+    int burnin   = (replicas>1 || starts>1) ? 0 : p->get<int>("burnin");
+    bool timed   = (p->get<int>("adapt_cost")==1);
+    rjmcmc::adaptive_sampler<sampler> adaptive(*samp,std::max(burnin,0),p->get<int>("adapt_period"),p->get<double>("adapt_floor"));
+    rjmcmc::adaptive_sampler<sampler,rjmcmc::cpu_time_cost> adaptive_time(*samp,std::max(burnin,0),p->get<int>("adapt_period"),p->get<double>("adapt_floor"));
+    any_sampler sampler = (burnin<=0) ? any_sampler(*samp) : timed ? any_sampler(adaptive_time) : any_sampler(adaptive);
 
     /*< Build and initialize simple visitor which prints some data on the standard output >*/
     typedef simulated_annealing::any_composite_visitor<configuration,any_sampler> any_visitor;
@@ -94,7 +118,29 @@ int main(int argc , char** argv)
     init_visitor(p,visitor);
 
     /*< This is the way to launch the optimization process. Here, the magic happens... >*/
-    simulated_annealing::optimize(e,*conf,sampler,*sch,*end,visitor);
+    if(starts>1)
+    {
+        std::vector<simulated_annealing::run_statistics> stats =
+                simulated_annealing::multi_start_optimize<Engine>(rjmcmc::master_seed(),starts,*conf,sampler,*sch,*end,p->get<int>("threads"));
+        std::cout << std::setw(8) << "Run" << std::setw(22) << "Seed" << std::setw(16) << "Energy"
+                  << std::setw(12) << "Iterations" << std::setw(12) << "Time(s)" << std::endl;
+        for(unsigned int i=0; i<stats.size(); ++i)
+            std::cout << std::setw(8) << stats[i].run << std::setw(22) << stats[i].seed << std::setw(16) << stats[i].energy
+                      << std::setw(12) << stats[i].iterations << std::setw(12) << stats[i].time << std::endl;
+        std::cout << "Best energy : " << conf->energy() << std::endl;
+    }
+    else if(replicas>1)
+        simulated_annealing::parallel_tempering(e,*conf,sampler,*sch,*end,visitor,
+                                                simulated_annealing::geometric_ladder(replicas,p->get<double>("ladder")),
+                                                p->get<int>("exchange"), p->get<int>("threads"));
+    else
+        simulated_annealing::optimize(e,*conf,sampler,*sch,*end,visitor);
+
+    if(burnin>0)
+    {
+        if(timed) report_tuned(adaptive_time);
+        else      report_tuned(adaptive);
+    }
 
     /*< Finally release all dynamically allocated resources >*/
     if(conf) {delete conf; conf=NULL;}
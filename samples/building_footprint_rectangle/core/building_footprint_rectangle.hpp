@@ -48,9 +48,16 @@ typedef Rectangle_2 object;
 //]
 
 //[building_footprint_rectangle_definition_kernels
+#ifdef USE_ALIAS_RASTER_VARIATE
+// O(1) sampling of the birth map, at 12 bytes per voxel instead of 8
+#include "rjmcmc/rjmcmc/kernel/alias_raster_variate.hpp"
+typedef rjmcmc::alias_raster_variate<5> birth_variate;
+#else
 #include "rjmcmc/rjmcmc/kernel/raster_variate.hpp"
+typedef rjmcmc::raster_variate<5> birth_variate;
+#endif
 #include "rjmcmc/mpp/kernel/uniform_birth.hpp"
-typedef marked_point_process::uniform_birth<object,rjmcmc::raster_variate<5> > uniform_birth;
+typedef marked_point_process::uniform_birth<object,birth_variate> uniform_birth;
 #include "rjmcmc/mpp/kernel/uniform_birth_death_kernel.hpp"
 typedef marked_point_process::uniform_birth_death_kernel<uniform_birth>::type  birth_death_kernel;
 
@@ -82,11 +89,11 @@ typedef marked_point_process::uniform_kernel<object,1,2,split_merge_transform>::
 
 //[building_footprint_rectangle_definition_energies
 #include "rjmcmc/rjmcmc/energy/energy_operators.hpp"
-#include "rjmcmc/mpp/energy/image_gradient_unary_energy.hpp"
+#include "rjmcmc/mpp/energy/cached_image_gradient_unary_energy.hpp"
 #include "rjmcmc/image/gradient_functor.hpp"
 #include "rjmcmc/image/oriented.hpp"
 typedef oriented<gradient_image_t>                          oriented_gradient_image;
-typedef image_gradient_unary_energy<oriented_gradient_image> unary_energy;
+typedef cached_image_gradient_unary_energy<oriented_gradient_image> unary_energy;
 
 #include "rjmcmc/mpp/energy/intersection_area_binary_energy.hpp"
 typedef intersection_area_binary_energy<>                   binary_energy;
@@ -110,11 +117,26 @@ typedef simulated_annealing::max_iteration_end_test     end_test;
 #include "rjmcmc/mpp/energy/image_center_unary_energy.hpp"
 typedef oriented<boost::gil::gray16_image_t> mask_type;
 #include "rjmcmc/mpp/configuration/graph_configuration.hpp"
+#include "rjmcmc/mpp/configuration/grid_accelerator.hpp"
+typedef minus_energy<constant_energy<>,multiplies_energy<constant_energy<>,unary_energy> > weighted_unary_energy;
+typedef multiplies_energy<constant_energy<>,binary_energy> weighted_binary_energy;
+typedef marked_point_process::grid_accelerator accelerator;
+#ifdef USE_FLAT_CONFIGURATION
+#include "rjmcmc/mpp/configuration/flat_graph_configuration.hpp"
+typedef marked_point_process::flat_graph_configuration<
+        object,
+        weighted_unary_energy,
+        weighted_binary_energy,
+        accelerator
+        > configuration;
+#else
 typedef marked_point_process::graph_configuration<
         object,
-        minus_energy<constant_energy<>,multiplies_energy<constant_energy<>,unary_energy> >,
-        multiplies_energy<constant_energy<>,binary_energy>
+        weighted_unary_energy,
+        weighted_binary_energy,
+        accelerator
         > configuration;
+#endif
 //]
 
 //[building_footprint_rectangle_definition_distribution
@@ -194,9 +216,12 @@ void create_configuration(const param *p, const oriented_gradient_image& grad, c
         boost::gil::write_view( mask_file+"_y.tif" , boost::gil::nth_channel_view(grad.view(),1), boost::gil::tiff_tag() );
     }
 
-    // empty initial configuration
+    // empty initial configuration, with a neighbour grid of cells about the size of the largest objects
+    Iso_rectangle_2 r = get_bbox(p);
+    accelerator grid(r.min().x(),r.min().y(),r.max().x(),r.max().y(),2*p->get<double>("maxsize"));
     c = new configuration( p->get<double>("energy")-(p->get<double>("ponderation_grad")*unary_energy(grad)),
-                           p->get<double>("ponderation_surface")*binary_energy());
+                           p->get<double>("ponderation_surface")*binary_energy(),
+                           grid);
 }
 //]
 
@@ -227,14 +252,14 @@ void create_sampler(const param *p, sampler *&s) {
     uniform_birth birth(
             Rectangle_2(r.min(),-v,minratio),
             Rectangle_2(r.max(), v,maxratio),
-            rjmcmc::raster_variate<5>(prob,size)
+            birth_variate(prob,size)
             );
 
     distribution cs(p->get<double>("poisson"));
 
     d_sampler ds( cs, birth );
 
-    typedef rjmcmc::mt19937_generator Engine;
+    typedef rjmcmc::generator Engine;
     Engine& e = rjmcmc::random();
     marked_point_process::graph_configuration<object, constant_energy<>, constant_energy<> > c(1,1);
     ds(e,c);
@@ -326,6 +351,8 @@ void init_visitor(const param *p, Visitor& v)
 #include "rjmcmc/image/image_types.hpp"
 #include "rjmcmc/image/oriented_inc.hpp"
 #include "rjmcmc/image/gradient_functor_inc.hpp"
+#include "rjmcmc/image/parallel_gradient_functor_inc.hpp"
+#include "rjmcmc/image/gradient_cache.hpp"
 //]
 
 //[building_footprint_rectangle_optimization
@@ -60,6 +60,10 @@ void initialize_parameters(T* params)
     params->template insert<double>("p_edge",'E',4, "Edge Transform Kernel probability");
     params->template insert<double>("p_corner",'C',4, "Corner Transform Kernel probability");
     params->template insert<double>("p_split_merge",'\0',1, "Split Merge Kernel probability");
+    params->template insert<int>("burnin",'\0',0, "Number of burn-in iterations tuning the kernel probabilities (0: fixed probabilities)");
+    params->template insert<int>("adapt_period",'\0',1000, "Number of burn-in iterations between kernel probability updates");
+    params->template insert<double>("adapt_floor",'\0',0.1, "Weight of the initial kernel probabilities in the tuned ones [0;1]");
+    params->template insert<int>("adapt_cost",'\0',0, "Cost of the proposals during the burn-in (0: energy evaluations, 1: CPU time)");
     params->template insert<double>("p_birth",'b',0.5, "Birth probability");
     params->template insert<double>("p_split",'\0',0.5, "Split probability");
     params->template insert<double>("ponderation_surface",'s',10, "Intersection area weight");
@@ -77,6 +81,13 @@ void initialize_parameters(T* params)
 //    params->template insert<int>("subsampling",'u',1, "Subsampling");
 //    params->template insert<double>("gaussian",'g',2, "Gaussian filter variance");
     params->template insert<double>("sigmaD",'G',1, "Kernel size for gradients computation");
+    params->template insert<boost::filesystem::path>("gradient_cache",'\0',"", "Directory of the cached gradients (empty: no cache)");
+    params->template insert<int>("replicas",'\0',1, "Number of parallel tempering replicas (1: single chain)");
+    params->template insert<double>("ladder",'\0',1.5, "Temperature ratio between adjacent replicas");
+    params->template insert<int>("exchange",'\0',1000, "Number of iterations between replica exchanges");
+    params->template insert<int>("threads",'\0',0, "Number of threads (0: one per core)");
+    params->template insert<int>("starts",'\0',1, "Number of independent runs, the best one is kept (1: single run)");
+    params->template insert<int>("seed",'\0',-1, "Random seed (negative: drawn from the clock)");
 }
 //]
 
@@ -82,7 +82,7 @@ class building_footprint_rectangle_gilviewer : public wx_plugin_base, public sim
     //]
 
 private:
-    typedef rjmcmc::mt19937_generator Engine;
+    typedef rjmcmc::generator Engine;
     typedef rjmcmc::any_sampler<Engine,configuration> any_sampler;
     typedef simulated_annealing::any_composite_visitor<configuration,any_sampler> any_composite_visitor;
 
@@ -205,7 +205,7 @@ public:
       //  std::cout << "Salamon initial schedule : " << salamon_initial_schedule(m_sampler->density(),*m_config,1000) << std::endl;
         m_config->clear();
 
-        typedef rjmcmc::mt19937_generator Engine;
+        typedef rjmcmc::generator Engine;
         Engine& e = rjmcmc::random();
         typedef rjmcmc::any_sampler<Engine,configuration> any_sampler;
 
@@ -0,0 +1,205 @@
+/***********************************************************************
+This file is part of the librjmcmc project source files.
+
+Copyright : Institut Geographique National (2008-2012)
+Contributors : Mathieu Brédif, Olivier Tournaire, Didier Boldo
+email : librjmcmc@ign.fr
+
+This software is a generic C++ library for stochastic optimization.
+
+This software is governed by the CeCILL license under French law and
+abiding by the rules of distribution of free software. You can use,
+modify and/or redistribute the software under the terms of the CeCILL
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info".
+
+As a counterpart to the access to the source code and rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty and the software's author, the holder of the
+economic rights, and the successive licensors have only limited liability.
+
+In this respect, the user's attention is drawn to the risks associated
+with loading, using, modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean that it is complicated to manipulate, and that also
+therefore means that it is reserved for developers and experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or
+data to be ensured and, more generally, to use and operate it in the
+same conditions as regards security.
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL license and that you accept its terms.
+
+***********************************************************************/
+
+// Tiling pipeline for DSMs too large for a single optimization : the region is split into tiles of 'tile' pixels,
+// each optimized independently with the parameters of building_footprint_rectangle_cli on its core dilated by 'overlap'.
+// Tiles are processed by rows, the tiles of a row concurrently on 'threads' threads, so that at most 'threads' tile
+// images are in memory. Duplicate objects of neighbouring tiles are resolved by energy, and the result is streamed
+// to 'output' as the rows complete (a shapefile if built with USE_SHP and output ends with .shp, text otherwise).
+
+#include "rjmcmc/param/parameter.hpp"
+typedef parameters< parameter > param;
+#include "building_footprint_rectangle_parameters_inc.hpp"
+
+#include "building_footprint_rectangle.hpp"
+
+#include <fstream>
+#include <boost/shared_ptr.hpp>
+#include "rjmcmc/util/parallel_for.hpp"
+#include "rjmcmc/geometry/intersection/Rectangle_2_intersection.hpp"
+#include "rjmcmc/mpp/tile_merger.hpp"
+#ifdef USE_SHP
+# include "rjmcmc/simulated_annealing/visitor/shp_visitor.hpp"
+#endif
+
+// parameters are not copyable : each tile gets its own list of parameters, with the values of p
+void copy_parameters(const param *p, param *q)
+{
+    for(param::const_iterator it=p->begin(); it!=p->end(); ++it)
+        q->insert(it->name(),it->shortcut(),it->value(),it->description());
+}
+
+struct tile_task {
+    boost::shared_ptr<param> p; // parameters of the tile, whose bbox is the core dilated by the overlap
+    Iso_rectangle_2 core;
+    unsigned int index;
+    std::vector< std::pair<Rectangle_2,double> > objects; // objects centered in the core, with their unary energy
+};
+
+struct tile_runner {
+    std::vector<tile_task>& m_tasks;
+    tile_runner(std::vector<tile_task>& tasks) : m_tasks(tasks) {}
+    void operator()(unsigned int i) const
+    {
+        tile_task& t = m_tasks[i];
+        param *p = t.p.get();
+        Iso_rectangle_2 bbox = get_bbox(p);
+        std::string dsm_file = p->get<boost::filesystem::path>("dsm").string();
+        // tiles already run concurrently : one thread per gradient
+        parallel_gradient_functor gf(p->get<double>("sigmaD"),1);
+        oriented_gradient_image grad_image = cached_gradient(dsm_file, bbox, gf, p->get<boost::filesystem::path>("gradient_cache").string());
+
+        configuration *conf; create_configuration(p,grad_image,conf);
+        sampler       *samp; create_sampler      (p,samp);
+        schedule      *sch ; create_schedule     (p,sch);
+        end_test      *end ; create_end_test     (p,end);
+
+        // the engine of a tile only depends on the master seed and the tile index
+        rjmcmc::generator e = rjmcmc::make_engine<rjmcmc::generator>(t.index);
+        simulated_annealing::optimize(e,*conf,*samp,*sch,*end);
+
+        for(configuration::const_iterator it=conf->begin(); it!=conf->end(); ++it)
+        {
+            const Rectangle_2& r = conf->value(it);
+            if(r.center().x()>=t.core.min().x() && r.center().x()<t.core.max().x() &&
+               r.center().y()>=t.core.min().y() && r.center().y()<t.core.max().y())
+                t.objects.push_back(std::make_pair(r,conf->energy(it)));
+        }
+        delete conf;
+        delete samp;
+        delete sch;
+        delete end;
+    }
+};
+
+struct text_writer {
+    typedef void result_type;
+    std::ostream& m_os;
+    text_writer(std::ostream& os) : m_os(os) {}
+    void operator()(const Rectangle_2& r) const { m_os << r << '\n'; }
+};
+
+template<typename Writer>
+int run(param *p, Writer& out)
+{
+    Iso_rectangle_2 bbox = get_bbox(p);
+    std::string dsm_file = p->get<boost::filesystem::path>("dsm").string();
+    clip_bbox(bbox, dsm_file);
+
+    // largest distance from the center of a rectangle to its corners
+    double maxsize  = p->get<double>("maxsize");
+    double maxratio = p->get<double>("maxratio");
+    double extent = maxsize*std::sqrt(1+maxratio*maxratio);
+    int tile    = std::max(1,p->get<int>("tile"));
+    int overlap = p->get<int>("overlap");
+    if(overlap<0) overlap = int(std::ceil(extent));
+
+    int x0 = (int) bbox.min().x(), y0 = (int) bbox.min().y();
+    int x1 = (int) bbox.max().x(), y1 = (int) bbox.max().y();
+    int nx = std::max(1,(x1-x0+tile-1)/tile);
+    int ny = std::max(1,(y1-y0+tile-1)/tile);
+    std::cout << nx << "x" << ny << " tiles of " << tile << " pixels, overlap " << overlap << std::endl;
+
+    marked_point_process::tile_merger<Rectangle_2> merger(extent);
+    for(int j=0; j<ny; ++j)
+    {
+        std::vector<tile_task> tasks(nx);
+        for(int i=0; i<nx; ++i)
+        {
+            tile_task& t = tasks[i];
+            t.core = Iso_rectangle_2(x0+i*tile,y0+j*tile,std::min(x1,x0+(i+1)*tile),std::min(y1,y0+(j+1)*tile));
+            t.index = i+nx*j;
+            t.p.reset(new param);
+            copy_parameters(p,t.p.get());
+            set_bbox(t.p.get(),Iso_rectangle_2(std::max(x0,(int) t.core.min().x()-overlap),std::max(y0,(int) t.core.min().y()-overlap),
+                                               std::min(x1,(int) t.core.max().x()+overlap),std::min(y1,(int) t.core.max().y()+overlap)));
+        }
+        rjmcmc::parallel_for(nx, tile_runner(tasks), p->get<int>("threads"));
+        for(int i=0; i<nx; ++i)
+            for(std::vector< std::pair<Rectangle_2,double> >::const_iterator it=tasks[i].objects.begin(); it!=tasks[i].objects.end(); ++it)
+                merger.add(it->first,it->second,tasks[i].index);
+        merger.flush_row(tasks[0].core.max().y(),out);
+        std::cout << "row " << j+1 << "/" << ny << " : " << merger.written() << " written, "
+                  << merger.held() << " held, " << merger.dropped() << " duplicates" << std::endl;
+    }
+    merger.flush(out);
+    std::cout << merger.written() << " objects written" << std::endl;
+    return 0;
+}
+
+int main(int argc , char** argv)
+{
+    param *p = new param;
+    initialize_parameters(p);
+    p->insert<int>("tile",'\0',1000, "Tile size (pixels)");
+    p->insert<int>("overlap",'\0',-1, "Tile overlap (pixels, negative: largest object extent)");
+    p->insert<boost::filesystem::path>("output",'o',"footprints.txt", "Output file (.shp with USE_SHP, text otherwise)");
+    if (!p->parse(argc, argv)) return -1;
+    if (p->get<int>("seed")>=0) rjmcmc::seed(p->get<int>("seed"));
+    if (p->get<boost::filesystem::path>("mask").string()!="")
+    {
+        std::cout << "mask is not supported by the tiling pipeline" << std::endl;
+        return -1;
+    }
+
+    int res;
+    boost::filesystem::path output = p->get<boost::filesystem::path>("output");
+#ifdef USE_SHP
+    if(output.extension()==".shp")
+    {
+        shp_writer writer(output.string());
+        if(!writer)
+        {
+            std::cout << "Unable to create SHP " << output.string() << std::endl;
+            return -1;
+        }
+        shp_writer_wrapper out(writer);
+        res = run(p,out);
+        delete p;
+        return res;
+    }
+#endif
+    std::ofstream file(output.string().c_str());
+    if(!file)
+    {
+        std::cout << "Unable to open : " << output.string() << std::endl;
+        return -1;
+    }
+    text_writer out(file);
+    res = run(p,out);
+    delete p;
+    return res;
+}
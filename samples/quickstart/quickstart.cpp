@@ -140,7 +140,7 @@ int main(int argc , char** argv)
     simulated_annealing::composite_visitor< simulated_annealing::ostream_visitor,simulated_annealing::tex_visitor> visitor(osvisitor,texvisitor);
 #endif
 
-    typedef rjmcmc::mt19937_generator Engine;
+    typedef rjmcmc::generator Engine;
     Engine& e = rjmcmc::random();
 
     visitor.init(nbdump,nbsave);
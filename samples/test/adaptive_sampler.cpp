@@ -0,0 +1,100 @@
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include "rjmcmc/util/random.hpp"
+#include "rjmcmc/rjmcmc/sampler/adaptive_sampler.hpp"
+#include "check.hpp"
+
+// checks that adaptive_sampler favours the kernel decreasing the energy during the burn-in, keeps the total probability
+// and the floor of the initial probabilities, freezes the probabilities afterwards, shares its statistics with its copies,
+// and tunes the same probabilities for the same seed, the cost of a proposal counting its unary and binary energy evaluations
+
+// configuration counting its accepted proposals and the unary and binary energy evaluations of the proposals
+struct mock_configuration
+{
+    int m_accepted;
+    unsigned long m_unary, m_evaluations;
+    mock_configuration() : m_accepted(0), m_unary(0), m_evaluations(0) {}
+    inline unsigned long unary_evaluations() const { return m_unary; }
+    inline unsigned long binary_evaluations() const { return m_evaluations; }
+};
+
+// two kernels : the first one always decreases the energy, the second one decreases it with probability bad (rejected otherwise)
+class mock_sampler
+{
+public:
+    enum { size = 2 };
+    mock_sampler(double bad=0) : m_rand(0,1), m_bad(bad), m_kernel_id(0), m_accepted(false), m_delta(0) { m_p[0] = 1; m_p[1] = 3; }
+
+    template<typename Engine, typename Configuration>
+    void operator()(Engine& e, Configuration &c, double temp)
+    {
+        m_kernel_id = (m_rand(e)*(m_p[0]+m_p[1]) < m_p[0]) ? 0 : 1;
+        m_accepted  = (m_kernel_id==0) || (m_rand(e)<m_bad);
+        m_delta     = m_accepted ? -1 : 1;
+        c.m_unary += 1;       // the unary energy of a birth
+        c.m_evaluations += 4; // some binary energy evaluations per proposal
+        c.m_accepted += m_accepted ? 1 : 0;
+    }
+
+    inline bool accepted() const { return m_accepted; }
+    inline double delta() const { return m_delta; }
+    inline const std::string& kernel_name(unsigned int i) const { static const std::string n[] = {"good","bad"}; return n[i]; }
+    inline unsigned int kernel_index() const { return m_kernel_id; }
+    inline unsigned int kernel_begin(unsigned int i) const { return i; }
+    inline double probability(unsigned int i) const { return m_p[i]; }
+    inline void probability(unsigned int i, double p) { m_p[i] = p; }
+
+private:
+    boost::uniform_real<> m_rand;
+    double m_bad;
+    unsigned int m_kernel_id;
+    bool m_accepted;
+    double m_delta;
+    double m_p[2];
+};
+
+int main(int argc, char **argv)
+{
+    rjmcmc::mt19937_generator e(3);
+    mock_configuration c;
+    rjmcmc::adaptive_sampler<mock_sampler> adaptive(mock_sampler(),5000,500,0.1);
+    rjmcmc::adaptive_sampler<mock_sampler> copy(adaptive);
+    for(int i=0; i<5000; ++i) copy(e,c,1.);
+    adaptive.report(std::cout);
+
+    check(copy.frozen() && adaptive.frozen(), "copies share their statistics");
+    check(copy.probability(0)>copy.probability(1), "the kernel decreasing the energy is favoured");
+    check(std::abs(copy.probability(0)+copy.probability(1)-4)<1e-9, "the total probability is kept");
+    check(std::abs(copy.probability(1)-0.1*3)<1e-9, "the floor of the initial probability is kept");
+    check(adaptive.tuned_probability(0)==copy.probability(0), "the tuned probabilities are reported");
+
+    double p0 = copy.probability(0);
+    for(int i=0; i<5000; ++i) copy(e,c,1.);
+    check(copy.probability(0)==p0, "the probabilities are frozen after the burn-in");
+
+    // the tuned probabilities depend on the random acceptances of the second kernel, but not on the timings
+    double p[2][2];
+    for(int run=0; run<2; ++run) {
+        rjmcmc::mt19937_generator e2(5);
+        mock_configuration c2;
+        rjmcmc::adaptive_sampler<mock_sampler> same(mock_sampler(0.3),5000,500,0.1);
+        for(int i=0; i<5000; ++i) same(e2,c2,1.);
+        p[run][0] = same.probability(0);
+        p[run][1] = same.probability(1);
+    }
+    check(p[0][1]>0.1*3 && p[0][0]==p[1][0] && p[0][1]==p[1][1], "the same seed tunes the same probabilities");
+
+    rjmcmc::evaluation_cost cost;
+    cost.start(c);
+    c.m_unary += 2;
+    c.m_evaluations += 3;
+    check(cost.stop(c)==1+2+3, "the unary and binary energy evaluations are counted");
+
+    // the CPU time is an opt-in cost
+    rjmcmc::adaptive_sampler<mock_sampler,rjmcmc::cpu_time_cost> timed(mock_sampler(),5000,500,0.1);
+    for(int i=0; i<5000; ++i) timed(e,c,1.);
+    check(timed.frozen() && std::abs(timed.probability(0)+timed.probability(1)-4)<1e-9, "the CPU time cost keeps the total probability");
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,68 @@
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include "rjmcmc/util/random.hpp"
+#include "rjmcmc/rjmcmc/kernel/raster_variate.hpp"
+#include "rjmcmc/rjmcmc/kernel/alias_raster_variate.hpp"
+#include "rjmcmc/rjmcmc/kernel/hierarchical_raster_variate.hpp"
+#include "check.hpp"
+
+// checks that the alias and hierarchical variates have the pdf of raster_variate, that the pdf returned by sampling
+// is the one of pdf(), and that the voxel frequencies match the pdf
+
+typedef rjmcmc::generator Engine;
+
+static double value[] = {
+    1, 2, 3, 2, 1,
+    0, 3, 3, 3, 0,
+    1, 2, 3, 2, 1,
+    5, 2, 0, 2, 1,
+    1, 2, 3, 2, 1,
+    6, 2, 7, 2, 9
+};
+static int size[] = {5,6};
+enum { voxels = 30 };
+
+template<typename Variate>
+void test(const Variate& var, const char *name, int iter)
+{
+    rjmcmc::raster_variate<2> ref(value,size);
+    Engine& engine = rjmcmc::random();
+    std::cout << name << std::endl;
+
+    bool same_pdf = true;
+    for(int i=0; i<voxels; ++i) {
+        double val[2] = { (i%size[0]+0.5)/size[0], (i/size[0]+0.5)/size[1] };
+        same_pdf = same_pdf && std::abs(var.pdf(val)-ref.pdf(val))<1e-6*ref.pdf(val)+1e-12;
+    }
+    check(same_pdf, "pdf of raster_variate");
+
+    int count[voxels] = {0};
+    bool consistent = true;
+    for(int k=0; k<iter; ++k) {
+        double val[2];
+        double pdf = var(engine,val);
+        consistent = consistent && pdf>0 && pdf==var.pdf(val);
+        ++count[int(val[0]*size[0])+size[0]*int(val[1]*size[1])];
+    }
+    check(consistent, "sampled pdf equals pdf()");
+
+    // each frequency within 5 standard deviations of its expectation
+    bool frequencies = true;
+    for(int i=0; i<voxels; ++i) {
+        double val[2] = { (i%size[0]+0.5)/size[0], (i/size[0]+0.5)/size[1] };
+        double p = var.pdf(val)/voxels;
+        frequencies = frequencies && std::abs(count[i]-iter*p)<=5*std::sqrt(iter*p*(1-p));
+    }
+    check(frequencies, "voxel frequencies");
+}
+
+int main(int argc, char **argv)
+{
+    int iter = 1000000;
+    if(argc>1) iter = atoi(argv[1]);
+    test(rjmcmc::alias_raster_variate<2>(value,size), "alias_raster_variate", iter);
+    test(rjmcmc::hierarchical_raster_variate<2>(value,size), "hierarchical_raster_variate (1 block)", iter);
+    test(rjmcmc::hierarchical_raster_variate<2>(value,size,4), "hierarchical_raster_variate (8 blocks)", iter);
+    return failures;
+}
@@ -0,0 +1,86 @@
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include "rjmcmc/util/random.hpp"
+
+#include "rjmcmc/geometry/geometry.hpp"
+#include "rjmcmc/geometry/Rectangle_2.hpp"
+#include "rjmcmc/geometry/intersection/Rectangle_2_intersection.hpp"
+#include "rjmcmc/rjmcmc/energy/constant_energy.hpp"
+#include "rjmcmc/rjmcmc/energy/energy_operators.hpp"
+#include "rjmcmc/mpp/energy/intersection_area_binary_energy.hpp"
+#include "rjmcmc/mpp/configuration/graph_configuration.hpp"
+#include "rjmcmc/mpp/configuration/flat_graph_configuration.hpp"
+#include "rjmcmc/mpp/configuration/grid_accelerator.hpp"
+#include "check.hpp"
+
+// checks that the energies cached by delta_energy are those inserted by apply, for modifications
+// with several births and deaths (split/merge like), and that apply evaluates no binary energy
+
+typedef geometry::Simple_cartesian<double> K;
+typedef geometry::Rectangle_2<K> Rectangle_2;
+typedef multiplies_energy<constant_energy<>,intersection_area_binary_energy<> > binary_energy;
+typedef marked_point_process::graph_configuration<Rectangle_2, constant_energy<>, binary_energy> graph_configuration;
+typedef marked_point_process::flat_graph_configuration<Rectangle_2, constant_energy<>, binary_energy, marked_point_process::grid_accelerator> flat_configuration;
+
+static Rectangle_2 random_rectangle(rjmcmc::mt19937_generator& e)
+{
+    boost::uniform_real<> u(0,1);
+    return Rectangle_2(K::Point_2(20*u(e),20*u(e)),K::Vector_2(1+3*u(e),3*u(e)-1.5),0.3+u(e));
+}
+
+template<typename Configuration>
+void test(const char *name, Configuration& c)
+{
+    rjmcmc::mt19937_generator e(7);
+    boost::uniform_int<> births(0,2), deaths(0,2);
+    double max_error = 0;
+    bool exact = true, counted = true;
+    for(int i=0; i<40; ++i) c.insert(random_rectangle(e));
+    for(int iter=0; iter<2000; ++iter) {
+        typename Configuration::modification modif;
+        int nd = std::min<int>(deaths(e),c.size());
+        for(int k=0; k<nd; ++k) {
+            boost::uniform_int<> pick(0,c.size()-1);
+            typename Configuration::const_iterator it = c.begin();
+            std::advance(it,pick(e));
+            if(std::find(modif.death().begin(),modif.death().end(),it)==modif.death().end())
+                modif.death().push_back(it);
+        }
+        for(int k=births(e); k>0; --k) modif.birth().push_back(random_rectangle(e));
+
+        double before = c.energy();
+        // the const evaluation counts in the given statistics only, the non-const one in the configuration
+        marked_point_process::interaction_statistics s;
+        unsigned long evaluations = c.binary_evaluations(), unary = c.unary_evaluations();
+        double const_delta = static_cast<const Configuration&>(c).delta_energy(modif,s);
+        counted = counted && (evaluations == c.binary_evaluations()) && (unary == c.unary_evaluations());
+        double delta = c.delta_energy(modif);
+        counted = counted && (const_delta == delta) && (c.binary_evaluations()-evaluations == s.evaluated)
+                          && (c.unary_evaluations()-unary == s.unary) && (s.unary == modif.birth().size());
+        evaluations = c.binary_evaluations();
+        unary = c.unary_evaluations();
+        modif.apply(c);
+        exact = exact && (evaluations == c.binary_evaluations()) && (unary == c.unary_evaluations());
+        max_error = std::max(max_error,std::abs(c.energy()-before-delta));
+    }
+    std::cout << name << " : " << c.size() << " objects, " << c.size_of_interactions() << " interactions" << std::endl;
+    check(max_error < 1e-6, "the energy variation is the delta energy");
+    check(exact, "apply evaluates no energy");
+    check(counted, "only the non-const delta_energy counts in the configuration");
+    check(c.audit_structure() == 0, "the interaction graph is complete");
+    check(std::abs(c.audit_unary_energy()-c.unary_energy()) < 1e-6, "the unary energy is consistent");
+    check(std::abs(c.audit_binary_energy()-c.binary_energy()) < 1e-6, "the binary energy is consistent");
+}
+
+int main()
+{
+    constant_energy<> e1(-1.);
+    binary_energy e2(10.,intersection_area_binary_energy<>());
+    graph_configuration g(e1,e2);
+    flat_configuration  f(e1,e2,marked_point_process::grid_accelerator(0,0,25,25,5));
+    test("graph",g);
+    test("flat" ,f);
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,15 @@
+#ifndef CHECK_HPP
+#define CHECK_HPP
+
+#include <iostream>
+
+// prints the result of a check of a test, and counts the failed checks
+
+static int failures = 0;
+static void check(bool b, const char *what)
+{
+    std::cout << (b ? "ok     " : "FAILED ") << what << std::endl;
+    if(!b) ++failures;
+}
+
+#endif // CHECK_HPP
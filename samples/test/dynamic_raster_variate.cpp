@@ -0,0 +1,113 @@
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include "rjmcmc/util/random.hpp"
+#include "rjmcmc/rjmcmc/kernel/raster_variate.hpp"
+#include "rjmcmc/rjmcmc/kernel/dynamic_raster_variate.hpp"
+
+#include "rjmcmc/geometry/geometry.hpp"
+#include "rjmcmc/geometry/Rectangle_2.hpp"
+#include "rjmcmc/geometry/intersection/Rectangle_2_intersection.hpp"
+#include "rjmcmc/rjmcmc/energy/constant_energy.hpp"
+#include "rjmcmc/mpp/configuration/graph_configuration.hpp"
+#include "rjmcmc/mpp/configuration/grid_accelerator.hpp"
+#include "rjmcmc/mpp/configuration/observed_accelerator.hpp"
+#include "rjmcmc/mpp/configuration/raster_occupancy_observer.hpp"
+#include "check.hpp"
+
+// checks that dynamic_raster_variate has the pdf of raster_variate, follows the updates of its weights,
+// and that a raster_occupancy_observer updates it on the insertion and removal of objects in a configuration
+
+typedef rjmcmc::generator Engine;
+typedef rjmcmc::dynamic_raster_variate<2> Variate;
+
+typedef geometry::Simple_cartesian<double> K;
+typedef geometry::Rectangle_2<K> Rectangle_2;
+typedef marked_point_process::raster_occupancy_observer<Variate> observer;
+typedef marked_point_process::observed_accelerator<observer,marked_point_process::grid_accelerator> accelerator;
+typedef marked_point_process::graph_configuration<Rectangle_2, constant_energy<>, constant_energy<>, accelerator> configuration;
+
+static double value[] = {
+    1, 2, 3, 2, 1,
+    0, 3, 3, 3, 0,
+    1, 2, 3, 2, 1,
+    5, 2, 0, 2, 1,
+    1, 2, 3, 2, 1,
+    6, 2, 7, 2, 9
+};
+static int size[] = {5,6};
+enum { voxels = 30 };
+
+static double voxel_pdf(const Variate& var, int i)
+{
+    double val[2] = { (i%size[0]+0.5)/size[0], (i/size[0]+0.5)/size[1] };
+    return var.pdf(val);
+}
+
+// sampled pdf equals pdf(), and each frequency is within 5 standard deviations of its expectation
+static void check_sampling(const Variate& var, int iter)
+{
+    Engine& engine = rjmcmc::random();
+    int count[voxels] = {0};
+    bool consistent = true;
+    for(int k=0; k<iter; ++k) {
+        double val[2];
+        double pdf = var(engine,val);
+        consistent = consistent && pdf>0 && pdf==var.pdf(val);
+        ++count[int(val[0]*size[0])+size[0]*int(val[1]*size[1])];
+    }
+    check(consistent, "sampled pdf equals pdf()");
+    bool frequencies = true;
+    for(int i=0; i<voxels; ++i) {
+        double p = voxel_pdf(var,i)/voxels;
+        frequencies = frequencies && std::abs(count[i]-iter*p)<=5*std::sqrt(iter*p*(1-p));
+    }
+    check(frequencies, "voxel frequencies");
+}
+
+int main(int argc, char **argv)
+{
+    int iter = 1000000;
+    if(argc>1) iter = atoi(argv[1]);
+
+    rjmcmc::raster_variate<2> ref(value,size);
+    Variate var(value,size);
+    bool same_pdf = true;
+    for(int i=0; i<voxels; ++i) {
+        double val[2] = { (i%size[0]+0.5)/size[0], (i/size[0]+0.5)/size[1] };
+        same_pdf = same_pdf && std::abs(var.pdf(val)-ref.pdf(val))<1e-12;
+    }
+    check(same_pdf, "pdf of raster_variate");
+    check_sampling(var,iter);
+
+    // updates through a copy : suppress the last row, raise a zero voxel
+    Variate copy(var);
+    for(int i=25; i<30; ++i) copy.weight(i,0.);
+    copy.weight(5,20.);
+    check(var.total_weight()==72.-26.+20., "updated total weight");
+    check(voxel_pdf(var,27)==0 && voxel_pdf(var,5)==20.*voxels/var.total_weight(), "updated pdf");
+    check_sampling(var,iter);
+
+    // births are suppressed in the cells overlapped by the objects of the configuration
+    Variate map(value,size);
+    observer obs(map,marked_point_process::bounding_box(0,0,50,60));
+    configuration c(constant_energy<>(0),constant_energy<>(0),
+                    accelerator(obs,marked_point_process::grid_accelerator(0,0,50,60,10)));
+    c.insert(Rectangle_2(K::Point_2(15,25),K::Vector_2(4,0),0.5)); // cells (1,2)
+    c.insert(Rectangle_2(K::Point_2(30,30),K::Vector_2(8,0),0.5)); // cells (2..3,2..3)
+    check(obs.count(1,2)==1 && obs.count(2,2)==1 && obs.count(3,3)==1 && obs.count(0,0)==0, "cell counts");
+    check(map.total_weight()==72., "birth map unchanged until apply()");
+    obs.apply();
+    check(map.weight(1+5*2)==0 && map.weight(3+5*3)==0 && map.weight(0)==1, "suppressed cells");
+    c.remove(c.begin());
+    check(map.weight(1+5*2)==0 && obs.count(1,2)==0, "removal counted until apply()");
+    obs.apply();
+    check(map.weight(1+5*2)==2 && map.weight(3+5*3)==0, "restored cells");
+    configuration c2(c);
+    obs.apply();
+    check(map.weight(3+5*3)==0 && obs.count(3,3)==1, "rebuilt by copy");
+    c.clear();
+    obs.apply();
+    check(map.total_weight()==72., "restored by clear");
+    return failures;
+}
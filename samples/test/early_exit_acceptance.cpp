@@ -0,0 +1,84 @@
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include "rjmcmc/util/random.hpp"
+
+#include "rjmcmc/geometry/geometry.hpp"
+#include "rjmcmc/geometry/Rectangle_2.hpp"
+#include "rjmcmc/geometry/intersection/Rectangle_2_intersection.hpp"
+#include "rjmcmc/rjmcmc/energy/constant_energy.hpp"
+#include "rjmcmc/rjmcmc/energy/energy_operators.hpp"
+#include "rjmcmc/mpp/energy/intersection_area_binary_energy.hpp"
+#include "rjmcmc/mpp/configuration/graph_configuration.hpp"
+#include "rjmcmc/mpp/configuration/flat_graph_configuration.hpp"
+#include "rjmcmc/mpp/configuration/vector_configuration.hpp"
+#include "rjmcmc/mpp/configuration/grid_accelerator.hpp"
+#include "rjmcmc/rjmcmc/acceptance/metropolis_acceptance.hpp"
+#include "check.hpp"
+
+// checks that the early exit of delta_energy(modif,max_delta) gives the decisions of the complete evaluation :
+// the returned value is the energy variation if it does not exceed max_delta, and a lower bound of it otherwise
+
+typedef geometry::Simple_cartesian<double> K;
+typedef geometry::Rectangle_2<K> Rectangle_2;
+typedef multiplies_energy<constant_energy<>,intersection_area_binary_energy<> > binary_energy;
+typedef marked_point_process::graph_configuration<Rectangle_2, constant_energy<>, binary_energy> graph_configuration;
+typedef marked_point_process::flat_graph_configuration<Rectangle_2, constant_energy<>, binary_energy, marked_point_process::grid_accelerator> flat_configuration;
+typedef marked_point_process::vector_configuration<Rectangle_2, constant_energy<>, binary_energy> vector_configuration;
+
+static Rectangle_2 random_rectangle(rjmcmc::mt19937_generator& e)
+{
+    boost::uniform_real<> u(0,1);
+    return Rectangle_2(K::Point_2(20*u(e),20*u(e)),K::Vector_2(1+3*u(e),3*u(e)-1.5),0.3+u(e));
+}
+
+template<typename Configuration>
+void test(const char *name, Configuration& c)
+{
+    rjmcmc::mt19937_generator e(11);
+    boost::uniform_int<> births(0,2), deaths(0,2);
+    boost::uniform_real<> rand(0,1);
+    rjmcmc::early_exit_metropolis_acceptance acceptance;
+    int same = 0, exits = 0, n = 2000;
+    for(int i=0; i<60; ++i) c.insert(random_rectangle(e));
+    for(int iter=0; iter<n; ++iter) {
+        typename Configuration::modification modif;
+        int nd = std::min<int>(deaths(e),c.size());
+        for(int k=0; k<nd; ++k) {
+            boost::uniform_int<> pick(0,c.size()-1);
+            typename Configuration::const_iterator it = c.begin();
+            std::advance(it,pick(e));
+            if(std::find(modif.death().begin(),modif.death().end(),it)==modif.death().end())
+                modif.death().push_back(it);
+        }
+        for(int k=births(e); k>0; --k) modif.birth().push_back(random_rectangle(e));
+
+        double max_delta = acceptance.max_delta(rand(e),0.1+10*rand(e),1.);
+        double bounded = c.delta_energy(modif,max_delta);
+        double delta = c.delta_energy(modif);
+        if(bounded > max_delta) {
+            ++exits;
+            if(delta > max_delta && bounded <= delta + 1e-9) ++same;
+        } else {
+            if(std::abs(bounded-delta) < 1e-9) ++same;
+            if(delta <= max_delta) modif.apply(c);
+        }
+    }
+    std::cout << name << " : " << exits << " rejections out of " << n << std::endl;
+    check(same == n, "the early exit gives the decision of the complete evaluation");
+    check(c.audit_structure() == 0, "the interaction graph is complete");
+}
+
+int main()
+{
+    constant_energy<> e1(-1.);
+    binary_energy e2(10.,intersection_area_binary_energy<>());
+    graph_configuration  g(e1,e2);
+    flat_configuration   f(e1,e2,marked_point_process::grid_accelerator(0,0,25,25,5));
+    vector_configuration v(e1,e2);
+    test("graph" ,g);
+    test("flat"  ,f);
+    test("vector",v);
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
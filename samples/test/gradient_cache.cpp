@@ -0,0 +1,92 @@
+#include <cstdio>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <boost/filesystem.hpp>
+#include <boost/gil/gil_all.hpp>
+#include <boost/gil/extension/io_new/tiff_write.hpp>
+#include "rjmcmc/geometry/geometry.hpp"
+#include "rjmcmc/image/gradient_functor_inc.hpp"
+#include "rjmcmc/image/gradient_cache.hpp"
+#include "check.hpp"
+
+// checks the cache hits of cached_gradient, and the recomputation of the gradient on a key mismatch, a corrupt entry or a missing file
+
+typedef geometry::Simple_cartesian<double> K;
+typedef K::Iso_rectangle_2 Iso_rectangle_2;
+namespace fs = boost::filesystem;
+
+// path of the only file of the extension ext in dir
+static fs::path entry(const fs::path& dir, const std::string& ext)
+{
+    fs::path res;
+    for(fs::directory_iterator it(dir); it!=fs::directory_iterator(); ++it)
+        if(it->path().extension()==ext) res = it->path();
+    return res;
+}
+
+static bool same(const oriented<gradient_image_t>& a, const oriented<gradient_image_t>& b)
+{
+    return a.x0()==b.x0() && a.y0()==b.y0() && a.view().dimensions()==b.view().dimensions()
+        && boost::gil::equal_pixels(a.view(),b.view());
+}
+
+// the gradient is mapped from the cache (img() is null) or computed (img() is not null)
+static bool mapped  (const oriented<gradient_image_t>& g) { return !g.img() && g.view().width()>0; }
+static bool computed(const oriented<gradient_image_t>& g) { return  g.img() && g.view().width()>0; }
+
+int main()
+{
+    const int w = 120, h = 80;
+    const std::string tif = "gradient_cache_test.tif";
+    const fs::path dir = "gradient_cache_test";
+    fs::remove_all(dir);
+
+    boost::gil::gray32f_image_t dsm(w,h);
+    for(int y=0; y<h; ++y)
+        for(int x=0; x<w; ++x)
+            boost::gil::view(dsm)(x,y) = 0.02f*x*y + 3.f*std::sin(0.1f*x);
+    boost::gil::write_view(tif, boost::gil::const_view(dsm), boost::gil::tiff_tag());
+
+    Iso_rectangle_2 bbox(10,5,100,70);
+    gradient_functor f(1.);
+    oriented<gradient_image_t> reference(tif, bbox, f);
+
+    oriented<gradient_image_t> first = cached_gradient(tif, bbox, f, dir.string());
+    check(computed(first) && same(first,reference), "first call computes the gradient");
+    fs::path map = entry(dir,".map"), key = entry(dir,".key");
+    check(!map.empty() && !key.empty(), "first call writes the entry");
+
+    oriented<gradient_image_t> hit = cached_gradient(tif, bbox, f, dir.string());
+    check(mapped(hit) && same(hit,reference), "second call maps the entry");
+
+    gradient_functor g(2.);
+    check(computed(cached_gradient(tif, bbox, g, dir.string())), "another sigma computes the gradient");
+
+    // a key file of another key, as with a hash collision
+    { std::ofstream out(key.string().c_str(), std::ios::binary); out << "another key\n"; }
+    oriented<gradient_image_t> mismatch = cached_gradient(tif, bbox, f, dir.string());
+    check(computed(mismatch) && same(mismatch,reference), "key mismatch computes the gradient");
+    check(mapped(cached_gradient(tif, bbox, f, dir.string())), "key mismatch rewrites the entry");
+
+    // a truncated entry
+    fs::resize_file(map, fs::file_size(map)/2);
+    oriented<gradient_image_t> corrupt = cached_gradient(tif, bbox, f, dir.string());
+    check(computed(corrupt) && same(corrupt,reference), "corrupt entry computes the gradient");
+    oriented<gradient_image_t> rewritten = cached_gradient(tif, bbox, f, dir.string());
+    check(mapped(rewritten) && same(rewritten,reference), "corrupt entry is rewritten");
+
+    // a missing file gives an empty gradient instead of throwing
+    bool thrown = false;
+    oriented<gradient_image_t> missing;
+    try {
+        missing = cached_gradient("gradient_cache_missing.tif", bbox, f, dir.string());
+    } catch(...) {
+        thrown = true;
+    }
+    check(!thrown && !missing.img() && missing.view().width()==0, "missing file gives an empty gradient");
+
+    fs::remove_all(dir);
+    fs::remove(tif);
+    return failures;
+}
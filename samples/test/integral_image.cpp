@@ -0,0 +1,46 @@
+#include <iostream>
+#include <cstdlib>
+#include "rjmcmc/geometry/geometry.hpp"
+#include "rjmcmc/geometry/Rectangle_2.hpp"
+#include "rjmcmc/geometry/Circle_2.hpp"
+#include "rjmcmc/image/oriented.hpp"
+#include "rjmcmc/geometry/image_error/all.hpp"
+#include "check.hpp"
+
+// checks that the sums over circles and rectangles computed on the integral image are the ones computed on the image
+
+typedef geometry::Simple_cartesian<double> K;
+typedef geometry::Rectangle_2<K> Rectangle_2;
+typedef geometry::Circle_2<K>    Circle_2;
+
+static double uniform(double a, double b) { return a+(b-a)*std::rand()/RAND_MAX; }
+
+int main(int argc, char **argv)
+{
+    typedef boost::gil::gray16_image_t image_t;
+    int w = 300, h = 200;
+    boost::shared_ptr<image_t> img(new image_t(w,h));
+    image_t::view_t v = boost::gil::view(*img);
+    for(int j=0; j<h; ++j)
+        for(int i=0; i<w; ++i)
+            v(i,j) = std::rand()%1000;
+    oriented<image_t> o(img,v,5,-7);
+    integral_image s(o);
+
+    check(s.sum(0,0,w,h)==s.sum(-10,-10,w+10,h+10), "box clipping");
+    double total = 0;
+    for(int j=0; j<h; ++j) total += s.row_sum(j,0,w);
+    check(total==s.sum(0,0,w,h), "row sums");
+
+    bool rectangles = true, circles = true;
+    for(int k=0; k<2000; ++k) {
+        K::Point_2 c(uniform(-20,320),uniform(-30,210));
+        Rectangle_2 r(c,K::Vector_2(uniform(-30,30),uniform(-30,30)),uniform(0.1,2.));
+        rectangles = rectangles && (image_error(o,r)==image_error(s,r));
+        Circle_2 ci(c,uniform(0,40));
+        circles = circles && (image_error(o,ci)==image_error(s,ci));
+    }
+    check(rectangles, "rectangle sums");
+    check(circles, "circle sums");
+    return failures;
+}
@@ -0,0 +1,70 @@
+#include <iostream>
+#include <vector>
+#include <boost/thread/thread.hpp>
+#include "rjmcmc/util/random.hpp"
+#include "check.hpp"
+
+// checks the engines against their reference outputs, and the reproducibility of the seeded engines of rjmcmc::random()
+
+// first n outputs of an engine
+template<typename Engine> std::vector<boost::uint64_t> draws(Engine& e, int n=16)
+{
+    std::vector<boost::uint64_t> res;
+    for(int i=0; i<n; ++i) res.push_back(e());
+    return res;
+}
+
+// first outputs of the engine of the thread
+struct draw {
+    std::vector<boost::uint64_t>& m_res;
+    draw(std::vector<boost::uint64_t>& res) : m_res(res) {}
+    void operator()() const { m_res = draws(rjmcmc::random()); }
+};
+
+int main(int argc, char **argv)
+{
+    rjmcmc::xoshiro256pp x;
+    x.seed(1,2,3,4);
+    bool bx = true;
+    const boost::uint64_t xref[] = { 0x2800001ULL, 0x3800067ULL, 0xcc00003800067ULL, 0xcc201994400b2ULL };
+    for(int i=0; i<4; ++i) bx = bx && (x()==xref[i]);
+    check(bx, "xoshiro256++ reference sequence");
+
+    rjmcmc::pcg32 p(42,54);
+    bool bp = true;
+    const boost::uint32_t pref[] = { 0xa15c02b7, 0x7b47f409, 0xba1d3330, 0x83d2f293, 0xbfa4784b, 0xcbed606e };
+    for(int i=0; i<6; ++i) bp = bp && (p()==pref[i]);
+    check(bp, "pcg32 reference sequence");
+
+    rjmcmc::pcg32 p0(42,54), p1(42,54);
+    for(int i=0; i<1000; ++i) p0();
+    p1.advance(1000);
+    check(p0==p1, "pcg32 advance");
+
+    rjmcmc::xoshiro256pp x0(7), x1(7);
+    x1.jump();
+    check(x0!=x1 && x0()!=x1(), "xoshiro256++ jump");
+
+    rjmcmc::seed(12345);
+    boost::uint64_t a = rjmcmc::random()();
+    rjmcmc::seed(12345);
+    boost::uint64_t b = rjmcmc::random()();
+    check(a==b, "reseeded engine reproducibility");
+
+    // the main thread uses stream 0 since the last seeding, the next thread uses stream 1
+    rjmcmc::seed(12345);
+    std::vector<boost::uint64_t> main_stream = draws(rjmcmc::random()), thread_stream;
+    boost::thread t((draw(thread_stream)));
+    t.join();
+    check(thread_stream!=main_stream, "independent thread stream");
+    rjmcmc::generator s0 = rjmcmc::make_engine<rjmcmc::generator>(0), s1 = rjmcmc::make_engine<rjmcmc::generator>(1);
+    check(main_stream==draws(s0) && thread_stream==draws(s1), "threads use the streams in the order of their first call");
+    check(rjmcmc::make_engine<rjmcmc::generator>(3)==rjmcmc::make_engine<rjmcmc::generator>(3), "per-chain engines");
+
+    rjmcmc::mt19937_generator m0, m1;
+    rjmcmc::seed_engine(m0, 0x0000000112345678ULL);
+    rjmcmc::seed_engine(m1, 0x0000000212345678ULL);
+    check(m0!=m1, "mt19937 seeded with the 64 bits of the stream seed");
+
+    return failures;
+}
@@ -0,0 +1,51 @@
+#include <iostream>
+#include <cstdlib>
+#include "rjmcmc/util/random.hpp"
+#include "rjmcmc/util/random_apply.hpp"
+#include "check.hpp"
+
+// checks that random_selector selects the elements of random_apply and passes them the same residual values,
+// bit for bit, and that it follows the updates of the probabilities
+
+struct element {
+    double m_p;
+    element(double p=1.) : m_p(p) {}
+    inline double probability() const { return m_p; }
+};
+
+// returns the residual value, passed as the first argument
+struct residual {
+    typedef double result_type;
+    inline double operator()(double x, const element&) const { return x; }
+};
+
+typedef rjmcmc::tuple<element,element,element,element,element> elements;
+
+int main(int argc, char **argv)
+{
+    elements t(element(0.3),element(0.1),element(0.45),element(0.15),element(0.7));
+    rjmcmc::random_selector<elements> selector(t);
+    rjmcmc::mt19937_generator e(5);
+    boost::uniform_real<> rand(0,1);
+    residual f;
+    bool same = true;
+    for(int k=0; k<100000; ++k) {
+        double x = rand(e);
+        unsigned int i, j;
+        double r = rjmcmc::random_apply(i,x,t,f);
+        double s = selector(j,x,t,f);
+        same = same && (i==j) && (r==s);
+    }
+    check(same, "same elements and residual values as random_apply");
+
+    rjmcmc::get<2>(t).m_p = 0;
+    selector.update(t);
+    bool skipped = true;
+    for(int k=0; k<100000; ++k) {
+        unsigned int i;
+        selector(i,rand(e),t,f);
+        skipped = skipped && (i!=2);
+    }
+    check(skipped, "an element of zero probability is never selected after update");
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,85 @@
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include "rjmcmc/util/random.hpp"
+#include "rjmcmc/rjmcmc/kernel/dynamic_raster_variate.hpp"
+
+#include "rjmcmc/geometry/geometry.hpp"
+#include "rjmcmc/geometry/Circle_2.hpp"
+#include "rjmcmc/geometry/coordinates/Circle_2_coordinates.hpp"
+#include "rjmcmc/rjmcmc/energy/constant_energy.hpp"
+#include "rjmcmc/mpp/configuration/graph_configuration.hpp"
+#include "rjmcmc/mpp/configuration/observed_accelerator.hpp"
+#include "rjmcmc/mpp/configuration/raster_occupancy_observer.hpp"
+#include "rjmcmc/mpp/kernel/uniform_birth.hpp"
+#include "rjmcmc/mpp/kernel/uniform_birth_death_kernel.hpp"
+#include "check.hpp"
+
+// checks the detailed balance of a birth and death kernel whose birth map is adapted by a raster_occupancy_observer :
+// the green ratio of the birth of an object and the green ratio of its death are inverses of each other
+
+typedef rjmcmc::generator Engine;
+typedef rjmcmc::dynamic_raster_variate<3> Variate;
+
+typedef geometry::Simple_cartesian<double> K;
+typedef geometry::Circle_2<K> Circle_2;
+typedef marked_point_process::raster_occupancy_observer<Variate> observer;
+typedef marked_point_process::observed_accelerator<observer> accelerator;
+typedef marked_point_process::graph_configuration<Circle_2, constant_energy<>, constant_energy<>, accelerator> configuration;
+typedef marked_point_process::uniform_birth<Circle_2,Variate> birth;
+typedef marked_point_process::uniform_birth_death_kernel<birth>::type kernel;
+
+static bool same(const Circle_2& a, const Circle_2& b)
+{
+    return a.center().x()==b.center().x() && a.center().y()==b.center().y() && a.radius()==b.radius();
+}
+
+int main(int argc, char **argv)
+{
+    int iter = 2000;
+    if(argc>1) iter = atoi(argv[1]);
+
+    static double value[] = {
+        1, 2, 3, 2, 1,
+        4, 3, 3, 3, 1,
+        1, 2, 3, 2, 1,
+        5, 2, 1, 2, 1
+    };
+    int size[] = {5,4,1};
+    Variate map(value,size);
+    observer obs(map,marked_point_process::bounding_box(0,0,50,40),0.25);
+    configuration c(constant_energy<>(0),constant_energy<>(0),accelerator(obs));
+    birth b(Circle_2(K::Point_2(0,0),1),Circle_2(K::Point_2(50,40),6),map);
+    kernel k = marked_point_process::make_uniform_birth_death_kernel(b,1.,0.5);
+
+    Engine& e = rjmcmc::random();
+    int unbalanced = 0, deaths = 0;
+    for(int i=0; i<iter; ++i) {
+        // the birth map is adapted between moves, as between runs
+        if(i%100==0) obs.apply();
+
+        configuration::modification m;
+        double birth_ratio = k(e,0.25,c,m);
+        if(birth_ratio==0) continue;
+        Circle_2 t = m.birth().front();
+        m.apply(c);
+
+        // death proposals until the death of the object that was born
+        double death_ratio = 0;
+        for(;;) {
+            configuration::modification d;
+            death_ratio = k(e,0.75,c,d);
+            if(d.death().size()==1 && same(c.value(d.death().front()),t)) {
+                // keep the configuration growing, so that births and deaths occur in occupied cells
+                if(std::rand()%2) d.apply(c);
+                break;
+            }
+        }
+        ++deaths;
+        if(std::abs(birth_ratio*death_ratio-1)>1e-9) ++unbalanced;
+    }
+    std::cout << unbalanced << " unbalanced births and deaths out of " << deaths << ", " << c.size() << " objects" << std::endl;
+    check(deaths>0, "births and deaths");
+    check(unbalanced==0, "detailed balance");
+    return failures;
+}
@@ -1,7 +1,7 @@
 #include "rjmcmc/util/random.hpp"
 #include "rjmcmc/rjmcmc/kernel/raster_variate.hpp"
 
-typedef rjmcmc::mt19937_generator  Engine;  // source of randomness
+typedef rjmcmc::generator  Engine;  // source of randomness
 typedef rjmcmc::raster_variate<2>  Variate; // random 2D point variate in the unit square
 
 int main(int argc, char **argv)
@@ -0,0 +1,48 @@
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include "rjmcmc/geometry/geometry.hpp"
+#include "rjmcmc/geometry/Rectangle_2.hpp"
+#include "rjmcmc/geometry/intersection/Rectangle_2_intersection.hpp"
+#include "rjmcmc/geometry/intersection/Rectangle_2_batch_intersection.hpp"
+#include "check.hpp"
+
+// checks the batched intersection areas of rectangles against intersection_area
+
+typedef geometry::Simple_cartesian<double> K;
+typedef geometry::Rectangle_2<K> Rectangle_2;
+
+static double uniform(double a, double b) { return a+(b-a)*std::rand()/RAND_MAX; }
+
+static Rectangle_2 random_rectangle()
+{
+    // some rectangles share the orientation of the reference, exercising the collinear cases of intersection_area
+    double a = (std::rand()%4==0) ? 0.5*M_PI*(std::rand()%4) : uniform(0,2*M_PI), l = uniform(1,10);
+    return Rectangle_2(K::Point_2(uniform(-15,15),uniform(-15,15)),K::Vector_2(l*std::cos(a),l*std::sin(a)),uniform(-2,2));
+}
+
+int main(int argc, char **argv)
+{
+    int n = 100000;
+    if(argc>1) n = atoi(argv[1]);
+    Rectangle_2 a(K::Point_2(0,0),K::Vector_2(8,0),0.5);
+    std::vector<Rectangle_2> b;
+    for(int i=0; i<n; ++i) b.push_back(random_rectangle());
+    std::vector<double> batch(n);
+    geometry::intersection_areas(a,&b[0],n,&batch[0]);
+
+    bool batched = true, zero = true;
+    int intersecting = 0;
+    for(int i=0; i<n; ++i) {
+        double ref = std::abs(geometry::intersection_area(a,b[i]));
+        double tol = 1e-9*std::abs(geometry::to_double(a.area()+b[i].area()));
+        batched = batched && std::abs(batch[i]-ref)<=tol;
+        zero = zero && (batch[i]==0 || geometry::do_intersect(a,b[i]));
+        intersecting += (ref>0);
+    }
+    std::cout << intersecting << " intersecting rectangles out of " << n << std::endl;
+    check(batched, "intersection_areas");
+    check(zero, "non zero areas of intersecting rectangles only");
+    return failures;
+}
@@ -15,7 +15,7 @@ struct Test
     }
 };
 
-typedef rjmcmc::mt19937_generator Engine;  // source of randomness
+typedef rjmcmc::generator Engine;  // source of randomness
 typedef rjmcmc::variate<2>        Variate; // random 2D point variate in the unit square
 
 template<typename Normalizer> void test(int iter, const Normalizer& normalizer)
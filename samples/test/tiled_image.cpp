@@ -0,0 +1,95 @@
+#include <cstdio>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <boost/gil/gil_all.hpp>
+#include <boost/gil/extension/io_new/tiff_write.hpp>
+#include "rjmcmc/geometry/geometry.hpp"
+#include "rjmcmc/geometry/Rectangle_2.hpp"
+#include "rjmcmc/geometry/integrated_flux/Rectangle_2_integrated_flux.hpp"
+#include "rjmcmc/image/gradient_functor_inc.hpp"
+#include "rjmcmc/image/oriented_inc.hpp"
+#include "rjmcmc/image/tiled_image_inc.hpp"
+#include "rjmcmc/image/mapped_image.hpp"
+#include "check.hpp"
+
+// checks that the gradient of a tiff file has the same integrated fluxes
+// when it is computed in memory, computed tile by tile with filtered_tile_source, and memory mapped
+
+typedef geometry::Simple_cartesian<double> K;
+typedef geometry::Rectangle_2<K> Rectangle_2;
+typedef K::Iso_rectangle_2 Iso_rectangle_2;
+typedef filtered_tile_source<gradient_functor> source_t;
+typedef tiled_image<gradient_image_t,source_t> tiled_t;
+
+static double uniform(double a, double b) { return a+(b-a)*std::rand()/RAND_MAX; }
+
+int main(int argc, char **argv)
+{
+    int n = 5000;
+    if(argc>1) n = atoi(argv[1]);
+    const int w = 300, h = 200;
+    const double sigma = 1.5;
+    const std::string tif = "tiled_image_test.tif", map = "tiled_image_test.map";
+
+    // a smooth dsm with a few buildings
+    boost::gil::gray32f_image_t dsm(w,h);
+    for(int y=0; y<h; ++y)
+        for(int x=0; x<w; ++x) {
+            float z = 0.01f*x + 5.f*std::sin(0.05f*y);
+            if((x/40)%2 && (y/30)%2) z += 10.f;
+            boost::gil::view(dsm)(x,y) = z;
+        }
+    boost::gil::write_view(tif, boost::gil::const_view(dsm), boost::gil::tiff_tag());
+
+    Iso_rectangle_2 bbox(0,0,w,h);
+    gradient_functor f(sigma);
+    oriented<gradient_image_t> memory(tif, bbox, f);
+    check(memory.img() && memory.view().width()==w && memory.view().height()==h, "gradient computed in memory");
+
+    // the margin covers the half size of the filter, 3*sigma
+    const int capacity = 4;
+    boost::shared_ptr<tiled_t> t(new tiled_t(source_t(tif,f,int(3*sigma)+2), 64, 64, capacity));
+    oriented<tiled_t> tiled(t, t->view(), 0, 0);
+
+    check(write_mapped_image(map, memory), "mapped image written");
+    oriented<gradient_image_t> mapped;
+    check(map_image(map, mapped), "mapped image mapped");
+    check(mapped.view().width()==w && mapped.view().height()==h && mapped.x0()==0 && mapped.y0()==0, "mapped image extent");
+
+    int tiled_mismatches = 0, mapped_mismatches = 0;
+    for(int i=0; i<n; ++i) {
+        double a = uniform(0,2*M_PI), l = uniform(1,40);
+        Rectangle_2 r(K::Point_2(uniform(0,w),uniform(0,h)),K::Vector_2(l*std::cos(a),l*std::sin(a)),uniform(0.1,2));
+        double flux = integrated_flux(memory,r);
+        if(integrated_flux(tiled ,r)!=flux) ++tiled_mismatches;
+        if(integrated_flux(mapped,r)!=flux) ++mapped_mismatches;
+    }
+    std::cout << tiled_mismatches << " tiled and " << mapped_mismatches << " mapped mismatches on " << n << " rectangles, "
+              << t->loads() << " tile loads" << std::endl;
+    check(tiled_mismatches==0, "tiled fluxes");
+    check(mapped_mismatches==0, "mapped fluxes");
+    check(t->resident()<=capacity, "resident tiles within capacity");
+
+    // an image of another channel type with pixels of the same size is not mapped
+    typedef boost::gil::image<boost::gil::pixel<boost::int32_t,boost::gil::devicen_layout_t<2> >,false> int_image_t;
+    oriented<int_image_t> other;
+    check(!map_image(map, other), "another channel type is rejected");
+
+    // neither is a file written with another byte order
+    {
+        std::fstream file(map.c_str(), std::ios::in|std::ios::out|std::ios::binary);
+        mapped_image_header header;
+        file.read((char*) &header, sizeof(header));
+        header.byte_order = 0x04030201;
+        file.seekp(0);
+        file.write((const char*) &header, sizeof(header));
+    }
+    oriented<gradient_image_t> swapped;
+    check(!map_image(map, swapped), "another byte order is rejected");
+
+    std::remove(tif.c_str());
+    std::remove(map.c_str());
+    return failures;
+}